@@ -0,0 +1,134 @@
+// Batch throughput: analyze() in a loop (with and without explanation strings)
+// vs. analyze_batch() at 1..max_threads workers. Also checks that every batch
+// result matches the sequential one.
+//
+// Usage: bench_analyze_batch [articles] [max_threads]
+
+#include "include/bias_aggregator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Deterministic mix of left/right/neutral vocabulary and lengths, so workers
+// see uneven items the way a real night batch does
+std::vector<ArticleInput> make_articles(size_t count) {
+    static const char* sentences[] = {
+        "Senator Biden praised the progressive reforms as essential for climate justice. ",
+        "Republicans warned about government overreach and rising regulatory burden. ",
+        "The free market initiative promotes business growth and innovation. ",
+        "Critics say the tax relief favors the wealthy while inequality grows. ",
+        "Officials expect a final vote after weeks of debate in the Senate. ",
+        "Trump told supporters that border security and law and order come first. ",
+        "Democrats called the bill a victory for worker rights and social equity. ",
+        "Analysts noted that markets were flat and turnout was unchanged. ",
+    };
+    static const char* domains[] = {"msnow.com", "foxnews.com", "reuters.com", "unknown.example"};
+    const size_t sentence_count = sizeof(sentences) / sizeof(sentences[0]);
+
+    std::vector<ArticleInput> articles;
+    articles.reserve(count);
+    uint32_t state = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 1103515245u + 12345u;
+        size_t length = 12 + (state >> 16) % 48;
+
+        ArticleInput article;
+        article.title = "Article " + std::to_string(i) + " on the Senate bill";
+        for (size_t s = 0; s < length; ++s) {
+            state = state * 1103515245u + 12345u;
+            article.body += sentences[(state >> 16) % sentence_count];
+        }
+        article.domain = domains[i % 4];
+        article.url = "https://" + article.domain + "/story/" + std::to_string(i);
+        articles.push_back(std::move(article));
+    }
+    return articles;
+}
+
+bool same_result(const BiasResult& a, const BiasResult& b) {
+    return a.score == b.score && a.label == b.label &&
+           a.confidence == b.confidence && a.explanations == b.explanations;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4000;
+    size_t max_threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 0;
+    if (max_threads == 0) {
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<ArticleInput> articles = make_articles(count);
+
+    BiasAggregator aggregator;
+    aggregator.analyze(articles[0]);  // warm-up: loads the lexicon
+
+    std::vector<BiasResult> expected;
+    expected.reserve(count);
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& article : articles) {
+        expected.push_back(aggregator.analyze(article));
+    }
+    double sequential = count / seconds_since(start);
+
+    AnalysisOptions scores_only;
+    scores_only.render_explanations = false;
+    size_t sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& article : articles) {
+        sink += aggregator.analyze(article, scores_only).signals.size();
+    }
+    double unexplained = count / seconds_since(start);
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "articles: " << count << "\n"
+              << "analyze() loop:        " << sequential << " articles/s\n"
+              << "  without explanations:  " << unexplained << " articles/s ("
+              << std::setprecision(2) << unexplained / sequential << "x)\n"
+              << std::setprecision(0);
+    if (sink == 0) {
+        std::cerr << "(every article was refused)" << std::endl;
+    }
+
+    // Explanations rendered later must match the ones formatted inline
+    bool all_match = true;
+    for (size_t i = 0; i < count; ++i) {
+        BiasResult deferred = aggregator.analyze(articles[i], scores_only);
+        all_match = all_match && aggregator.explain(deferred) == expected[i].explanations;
+    }
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        aggregator.set_thread_count(threads);
+        aggregator.analyze_batch(articles);  // warm-up: starts the pool
+
+        start = std::chrono::steady_clock::now();
+        std::vector<BiasResult> results = aggregator.analyze_batch(articles);
+        double rate = count / seconds_since(start);
+
+        for (size_t i = 0; i < count; ++i) {
+            all_match = all_match && same_result(results[i], expected[i]);
+        }
+        std::cout << "analyze_batch, " << std::setw(2) << threads << " threads: "
+                  << rate << " articles/s (" << std::setprecision(2)
+                  << rate / sequential << "x)\n" << std::setprecision(0);
+
+        if (threads * 2 > max_threads && threads != max_threads) {
+            threads = max_threads / 2;  // always finish on max_threads
+        }
+    }
+
+    std::cout << (all_match ? "results match analyze()" : "MISMATCH against analyze()") << std::endl;
+    return all_match ? 0 : 1;
+}
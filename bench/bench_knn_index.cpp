@@ -0,0 +1,159 @@
+// kNN index over synthetic clustered embeddings (like topic clusters of
+// news articles): HNSW build time, then per-query latency and recall@10
+// against exact brute-force search at several search breadths.
+//
+// Usage: bench_knn_index [count] [dim] [queries] [threads]
+
+#include "include/knn_index_builder.hpp"
+#include "include/similarity_kernel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kNeighbors = 10;
+constexpr size_t kLatentDimensions = 24;
+
+// Points around random cluster centers, spread along a few shared latent
+// directions plus a little isotropic noise: real embeddings have a low
+// intrinsic dimension, uniform noise in all dimensions would not
+std::vector<float> clustered(size_t count, size_t dim, size_t clusters, uint32_t seed,
+                             const std::vector<float>& centers, const std::vector<float>& basis) {
+    const size_t latent = basis.size() / dim;
+    std::mt19937 random(seed);
+    std::normal_distribution<float> spread(0.0f, 0.3f);
+    std::normal_distribution<float> noise(0.0f, 0.02f / std::sqrt(static_cast<float>(dim)));
+    std::uniform_int_distribution<size_t> pick(0, clusters - 1);
+    std::vector<float> points(count * dim);
+    for (size_t i = 0; i < count; ++i) {
+        float* point = points.data() + i * dim;
+        const float* center = centers.data() + pick(random) * dim;
+        for (size_t d = 0; d < dim; ++d) {
+            point[d] = center[d] + noise(random);
+        }
+        for (size_t l = 0; l < latent; ++l) {
+            const float z = spread(random);
+            for (size_t d = 0; d < dim; ++d) {
+                point[d] += z * basis[l * dim + d];
+            }
+        }
+    }
+    return points;
+}
+
+void normalize_rows(std::vector<float>& rows, size_t dim) {
+    for (size_t i = 0; i < rows.size(); i += dim) {
+        double norm = 0.0;
+        for (size_t d = 0; d < dim; ++d) {
+            norm += static_cast<double>(rows[i + d]) * rows[i + d];
+        }
+        const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+        for (size_t d = 0; d < dim; ++d) {
+            rows[i + d] *= scale;
+        }
+    }
+}
+
+// Exact top-k ids of each query, by scanning every vector
+std::vector<std::vector<uint32_t>> exact(const std::vector<float>& base, const std::vector<float>& queries,
+                                         size_t dim) {
+    const size_t count = base.size() / dim;
+    const size_t query_count = queries.size() / dim;
+    std::vector<std::vector<uint32_t>> truth(query_count);
+    std::vector<float> scores(count);
+    std::vector<uint32_t> order(count);
+    for (size_t q = 0; q < query_count; ++q) {
+        SimilarityKernel::cosine(queries.data() + q * dim, 1, base.data(), count, dim, scores.data());
+        for (uint32_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        std::partial_sort(order.begin(), order.begin() + kNeighbors, order.end(),
+                          [&](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+        truth[q].assign(order.begin(), order.begin() + kNeighbors);
+    }
+    return truth;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t dim = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 300;
+    size_t query_count = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 500;
+    size_t threads = (argc > 4) ? std::strtoul(argv[4], nullptr, 10) : 0;
+    const size_t clusters = std::max<size_t>(1, count / 500);
+
+    std::mt19937 random(7);
+    std::normal_distribution<float> unit(0.0f, 1.0f / std::sqrt(static_cast<float>(dim)));
+    std::vector<float> centers(clusters * dim);
+    for (float& v : centers) {
+        v = unit(random);
+    }
+    std::vector<float> basis(kLatentDimensions * dim);
+    for (float& v : basis) {
+        v = unit(random);
+    }
+    std::vector<float> base = clustered(count, dim, clusters, 11, centers, basis);
+    std::vector<float> queries = clustered(query_count, dim, clusters, 13, centers, basis);
+    normalize_rows(base, dim);
+    normalize_rows(queries, dim);
+
+    KnnIndexBuilder builder(dim, KnnSpace::WordVectors);
+    for (size_t i = 0; i < count; ++i) {
+        builder.add(base.data() + i * dim, (i % 2) ? 0.5f : -0.5f);
+    }
+    KnnIndexBuilder::Options options;
+    options.threads = threads;
+    auto start = std::chrono::steady_clock::now();
+    KnnIndex index;
+    if (!index.load_image(builder.compile(options))) {
+        std::cerr << "compiled image failed validation" << std::endl;
+        return 1;
+    }
+    const double build_seconds = seconds_since(start);
+
+    std::vector<std::vector<uint32_t>> truth = exact(base, queries, dim);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "vectors: " << count << " x " << dim << " in " << clusters << " clusters ("
+              << kLatentDimensions << " latent dimensions), "
+              << query_count << " queries, kernel: " << SimilarityKernel::name(SimilarityKernel::best())
+              << "\nbuild (m " << options.m << ", ef_construction " << options.ef_construction
+              << "): " << build_seconds << " s\n";
+
+    std::vector<KnnNeighbor> found(kNeighbors);
+    std::vector<double> latencies(query_count);
+    for (size_t ef : {16, 32, 64, 128, 256}) {
+        size_t hits = 0;
+        for (size_t q = 0; q < query_count; ++q) {
+            auto query_start = std::chrono::steady_clock::now();
+            size_t n = index.search(queries.data() + q * dim, kNeighbors, ef, found.data());
+            latencies[q] = seconds_since(query_start) * 1e6;
+            for (size_t i = 0; i < n; ++i) {
+                hits += std::count(truth[q].begin(), truth[q].end(), found[i].id);
+            }
+        }
+        std::sort(latencies.begin(), latencies.end());
+        double mean = 0.0;
+        for (double latency : latencies) {
+            mean += latency;
+        }
+        mean /= query_count;
+        std::cout << "  ef " << std::setw(3) << ef << ": recall@10 " << std::setprecision(3)
+                  << static_cast<double>(hits) / (query_count * kNeighbors) << std::setprecision(1)
+                  << ", " << std::setw(6) << mean << " us/query mean, " << std::setw(6)
+                  << latencies[query_count * 99 / 100] << " us p99\n";
+    }
+    return 0;
+}
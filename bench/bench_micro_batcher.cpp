@@ -0,0 +1,138 @@
+// Padding efficiency of length-bucketed batches (MicroBatcher) vs. batches
+// in arrival order, over the sentences of synthetic news articles as a
+// BERT-family model would see them: the title, then each body sentence,
+// cut into WordPiece ids with a vocab.txt if one is given.
+//
+// Usage: bench_micro_batcher [articles] [vocab.txt]
+
+#include "micro_batcher.hpp"
+#include "wordpiece_tokenizer.hpp"
+#include "include/sentence_splitter.hpp"
+#include "include/types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Ids per sequence including [CLS] and [SEP]; longer sentences are truncated
+constexpr size_t kMaxSequenceLength = 128;
+
+// Headlines, one-liners and long compound sentences, so sentence lengths
+// spread the way they do in news text
+std::vector<ArticleInput> make_articles(size_t count) {
+    static const char* sentences[] = {
+        "Markets were flat. ",
+        "The vote is expected on Tuesday. ",
+        "Senator Biden praised the progressive reforms as essential for climate justice. ",
+        "Republicans warned about government overreach and rising regulatory burden. ",
+        "Critics say the tax relief favors the wealthy while inequality grows, and several "
+        "economists who testified before the committee on Thursday argued that the projected "
+        "revenue losses would fall hardest on states that rely on federal transfers. ",
+        "Trump told supporters that border security and law and order come first. ",
+        "Democrats called the bill a victory for worker rights and social equity, pointing to "
+        "provisions on overtime pay, union elections and paid family leave that had stalled in "
+        "previous sessions of Congress. ",
+        "Turnout was unchanged. ",
+    };
+    static const char* domains[] = {"msnow.com", "foxnews.com", "reuters.com", "unknown.example"};
+    const size_t sentence_count = sizeof(sentences) / sizeof(sentences[0]);
+
+    std::vector<ArticleInput> articles;
+    articles.reserve(count);
+    uint32_t state = 2024;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 1103515245u + 12345u;
+        size_t length = 8 + (state >> 16) % 32;
+
+        ArticleInput article;
+        article.title = "Senate bill " + std::to_string(i) + " heads to a final vote";
+        for (size_t s = 0; s < length; ++s) {
+            state = state * 1103515245u + 12345u;
+            article.body += sentences[(state >> 16) % sentence_count];
+        }
+        article.domain = domains[i % 4];
+        articles.push_back(std::move(article));
+    }
+    return articles;
+}
+
+// Sequence length of every sentence of every article, in arrival order
+std::vector<uint32_t> sentence_lengths(const std::vector<ArticleInput>& articles,
+                                       const WordPieceTokenizer* tokenizer) {
+    std::vector<uint32_t> lengths;
+    std::vector<std::string_view> sentences;
+    std::vector<TextSpan> spans;
+    std::vector<int64_t> ids;
+    for (const auto& article : articles) {
+        sentences.assign(1, article.title);
+        spans.clear();
+        SentenceSplitter::split(article.body, 0, spans);
+        for (const TextSpan& span : spans) {
+            sentences.push_back(std::string_view(article.body).substr(span.offset, span.length));
+        }
+        for (std::string_view sentence : sentences) {
+            if (tokenizer != nullptr) {
+                tokenizer->encode(sentence, kMaxSequenceLength, ids);
+                lengths.push_back(static_cast<uint32_t>(ids.size()));
+            } else {
+                // No vocabulary: words + punctuation + [CLS]/[SEP] approximates it
+                uint32_t words = 1;
+                for (char c : sentence) {
+                    words += (c == ' ' || c == ',' || c == '.');
+                }
+                lengths.push_back(std::min<uint32_t>(words + 2, kMaxSequenceLength));
+            }
+        }
+    }
+    return lengths;
+}
+
+std::vector<SequenceBatch> arrival_order(const std::vector<uint32_t>& lengths, size_t max_batch) {
+    std::vector<SequenceBatch> batches;
+    for (size_t i = 0; i < lengths.size(); ++i) {
+        if (i % max_batch == 0) {
+            batches.emplace_back();
+        }
+        batches.back().items.push_back(static_cast<uint32_t>(i));
+        batches.back().padded_length = std::max(batches.back().padded_length, lengths[i]);
+    }
+    return batches;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    std::vector<ArticleInput> articles = make_articles(count);
+
+    WordPieceTokenizer vocabulary;
+    const WordPieceTokenizer* tokenizer = nullptr;
+    if (argc > 2) {
+        if (!vocabulary.load(argv[2])) {
+            std::cerr << vocabulary.error() << std::endl;
+            return 1;
+        }
+        tokenizer = &vocabulary;
+    }
+
+    const MicroBatcher::Limits limits;
+    std::vector<uint32_t> lengths = sentence_lengths(articles, tokenizer);
+    std::vector<SequenceBatch> naive = arrival_order(lengths, limits.max_batch);
+    std::vector<SequenceBatch> planned = MicroBatcher::plan(lengths, limits);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "articles: " << count << ", sentences: " << lengths.size()
+              << (tokenizer ? "" : " (lengths approximated, no vocab.txt)") << "\n"
+              << "real tokens / padded tokens:\n"
+              << "  arrival order:    " << 100.0 * MicroBatcher::efficiency(lengths, naive)
+              << "% in " << naive.size() << " batches\n"
+              << "  length-bucketed:  " << 100.0 * MicroBatcher::efficiency(lengths, planned)
+              << "% in " << planned.size() << " batches\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Sentence splitting throughput: SentenceSplitter vs. the previous std::regex path.
+//
+// Usage: bench_sentence_splitter [article_kb] [iterations]
+
+#include "include/sentence_splitter.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The splitter Preprocessor used before SentenceSplitter, kept verbatim for comparison
+std::vector<std::string> regex_split(const std::string& text) {
+    std::vector<std::string> sentences;
+    std::regex sentence_regex(R"([^.!?]+[.!?]+)");
+
+    auto begin = std::sregex_iterator(text.begin(), text.end(), sentence_regex);
+    auto end = std::sregex_iterator();
+
+    for (auto it = begin; it != end; ++it) {
+        std::string sentence = it->str();
+        sentence.erase(0, sentence.find_first_not_of(" \t\n\r"));
+        sentence.erase(sentence.find_last_not_of(" \t\n\r") + 1);
+        if (!sentence.empty()) {
+            sentences.push_back(sentence);
+        }
+    }
+
+    return sentences;
+}
+
+std::string make_article(size_t bytes) {
+    static const char* paragraph =
+        "After weeks of debate, the Senate passed the bill 52-48. Sen. Warren said "
+        "the vote was \"a turning point.\" Republicans, led by Mr. McConnell, warned "
+        "of a 3.5% rise in costs... Critics in the U.S. House disagree! Will it pass? "
+        "Officials expect a final vote on Jan. 12 at 10 a.m. local time.\n";
+    std::string text;
+    text.reserve(bytes + 512);
+    while (text.size() < bytes) {
+        text += paragraph;
+    }
+    return text;
+}
+
+template <typename Fn>
+double megabytes_per_second(const std::string& text, int iterations, Fn&& fn) {
+    size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += fn(text);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (sink == 0) {
+        std::cerr << "(no sentences found)" << std::endl;
+    }
+    return (static_cast<double>(text.size()) * iterations) / (1024.0 * 1024.0) / elapsed;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t article_kb = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int iterations = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+    std::string text = make_article(article_kb * 1024);
+    std::vector<TextSpan> spans;
+
+    double scanner = megabytes_per_second(text, iterations, [&](const std::string& t) {
+        spans.clear();
+        SentenceSplitter::split(t, 0, spans);
+        return spans.size();
+    });
+    double regex = megabytes_per_second(text, iterations, [](const std::string& t) {
+        return regex_split(t).size();
+    });
+
+    // Long input without any punctuation: the regex path can overflow the stack here,
+    // so only the scanner is measured
+    std::string unpunctuated(article_kb * 1024, 'a');
+    for (size_t i = 7; i < unpunctuated.size(); i += 8) {
+        unpunctuated[i] = ' ';
+    }
+    double scanner_unpunctuated = megabytes_per_second(unpunctuated, iterations, [&](const std::string& t) {
+        spans.clear();
+        SentenceSplitter::split(t, 0, spans);
+        return spans.size();
+    });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "article size: " << article_kb << " KB, iterations: " << iterations << "\n"
+              << "SentenceSplitter:            " << scanner << " MB/s\n"
+              << "std::regex (previous):       " << regex << " MB/s\n"
+              << "speedup:                     " << scanner / regex << "x\n"
+              << "SentenceSplitter, no punct.: " << scanner_unpunctuated << " MB/s\n";
+    return 0;
+}
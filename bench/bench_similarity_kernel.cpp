@@ -0,0 +1,115 @@
+// Cosine similarity of a batch of article vectors against a matrix of
+// reference axes: one pair at a time in double (the former per-reference
+// loop) vs. SimilarityKernel with each instruction set this CPU supports.
+// Also checks that every kernel agrees with the double-precision result.
+//
+// Usage: bench_similarity_kernel [batch] [axes] [dim] [rounds]
+
+#include "include/similarity_kernel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+std::vector<float> random_matrix(size_t rows, size_t dim, uint32_t seed) {
+    std::vector<float> values(rows * dim);
+    uint32_t state = seed;
+    for (float& v : values) {
+        state = state * 1103515245u + 12345u;
+        v = static_cast<float>((state >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+    }
+    return values;
+}
+
+double pairwise_cosine(const float* a, const float* b, size_t n) {
+    double dot = 0.0, norm_a = 0.0, norm_b = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        dot += a[i] * b[i];
+        norm_a += a[i] * a[i];
+        norm_b += b[i] * b[i];
+    }
+    norm_a = std::sqrt(norm_a);
+    norm_b = std::sqrt(norm_b);
+    return (norm_a < 1e-6 || norm_b < 1e-6) ? 0.0 : dot / (norm_a * norm_b);
+}
+
+void pairwise(const std::vector<float>& rows, size_t batch, const std::vector<float>& axes,
+              size_t axis_count, size_t dim, float* out) {
+    for (size_t b = 0; b < batch; ++b) {
+        for (size_t a = 0; a < axis_count; ++a) {
+            out[b * axis_count + a] = static_cast<float>(
+                pairwise_cosine(rows.data() + b * dim, axes.data() + a * dim, dim));
+        }
+    }
+}
+
+template <typename Run>
+double nanoseconds_per_row(Run run, size_t batch, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        run();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / (static_cast<double>(batch) * rounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t batch = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    size_t axis_count = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 32;
+    size_t dim = (argc > 3) ? std::strtoul(argv[3], nullptr, 10) : 300;
+    int rounds = (argc > 4) ? std::atoi(argv[4]) : 20;
+
+    std::vector<float> rows = random_matrix(batch, dim, 17);
+    std::vector<float> axes = random_matrix(axis_count, dim, 29);
+    std::vector<float> expected(batch * axis_count);
+    std::vector<float> out(batch * axis_count);
+    pairwise(rows, batch, axes, axis_count, dim, expected.data());
+
+    std::cout << "batch: " << batch << ", axes: " << axis_count << ", dim: " << dim
+              << ", rounds: " << rounds << "\n"
+              << "best: " << SimilarityKernel::name(SimilarityKernel::best()) << "\n"
+              << std::fixed << std::setprecision(0)
+              << "pairwise (double): " << std::setw(10)
+              << nanoseconds_per_row([&] { pairwise(rows, batch, axes, axis_count, dim, out.data()); },
+                                     batch, rounds)
+              << " ns/row\n";
+
+    bool all_match = true;
+    const SimilarityKernel::Isa isas[] = {SimilarityKernel::Isa::Scalar, SimilarityKernel::Isa::Avx2,
+                                          SimilarityKernel::Isa::Avx512};
+    for (SimilarityKernel::Isa isa : isas) {
+        if (!SimilarityKernel::supported(isa)) {
+            std::cout << std::setw(17) << std::left << SimilarityKernel::name(isa) << std::right
+                      << "   (not supported)\n";
+            continue;
+        }
+        SimilarityKernel::cosine(isa, rows.data(), batch, axes.data(), axis_count, dim, out.data());
+        double max_error = 0.0;
+        for (size_t i = 0; i < out.size(); ++i) {
+            max_error = std::max(max_error, static_cast<double>(std::abs(out[i] - expected[i])));
+        }
+        all_match = all_match && max_error < 1e-4;
+
+        double ns = nanoseconds_per_row(
+            [&] {
+                SimilarityKernel::cosine(isa, rows.data(), batch, axes.data(), axis_count, dim,
+                                         out.data());
+            },
+            batch, rounds);
+        std::cout << std::setw(17) << std::left << SimilarityKernel::name(isa) << std::right
+                  << ": " << std::setw(10) << ns << " ns/row   max error "
+                  << std::scientific << std::setprecision(1) << max_error
+                  << std::fixed << std::setprecision(0) << "\n";
+    }
+
+    std::cout << (all_match ? "results match" : "MISMATCH between kernels") << std::endl;
+    return all_match ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// Per-article latency: BiasAggregator (virtual signals, weights by name) vs.
+// DefaultStaticBiasAggregator (tuple of signals, fixed weight array), with and
+// without explanation strings. Also checks that both produce the same results.
+//
+// Usage: bench_static_aggregator [articles] [rounds]
+
+#include "include/bias_aggregator.hpp"
+#include "include/static_bias_aggregator.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<ArticleInput> make_articles(size_t count) {
+    static const char* sentences[] = {
+        "Senator Biden praised the progressive reforms as essential for climate justice. ",
+        "Republicans warned about government overreach and rising regulatory burden. ",
+        "The free market initiative promotes business growth and innovation. ",
+        "Critics say the tax relief favors the wealthy while inequality grows. ",
+        "Trump told supporters that border security and law and order come first. ",
+        "Analysts noted that markets were flat and turnout was unchanged. ",
+    };
+    static const char* domains[] = {"msnow.com", "foxnews.com", "reuters.com", "unknown.example"};
+    const size_t sentence_count = sizeof(sentences) / sizeof(sentences[0]);
+
+    std::vector<ArticleInput> articles;
+    articles.reserve(count);
+    uint32_t state = 777;
+    for (size_t i = 0; i < count; ++i) {
+        ArticleInput article;
+        article.title = "Article " + std::to_string(i);
+        for (size_t s = 0; s < 24; ++s) {
+            state = state * 1103515245u + 12345u;
+            article.body += sentences[(state >> 16) % sentence_count];
+        }
+        article.domain = domains[i % 4];
+        articles.push_back(std::move(article));
+    }
+    return articles;
+}
+
+template <typename Aggregator>
+double nanoseconds_per_article(const Aggregator& aggregator,
+                               const std::vector<ArticleInput>& articles,
+                               const AnalysisOptions& options, int rounds) {
+    double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& article : articles) {
+            sink += aggregator.analyze(article, options).score;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    if (std::isnan(sink)) {
+        std::cerr << "(nan)" << std::endl;
+    }
+    return elapsed / (static_cast<double>(articles.size()) * rounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    int rounds = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    std::vector<ArticleInput> articles = make_articles(count);
+    const BiasAggregator dynamic_aggregator;
+    const DefaultStaticBiasAggregator static_aggregator;
+
+    // Same scores, labels and explanations (weights may differ in the last bit
+    // because the dynamic aggregator sums them in hash-map order); run without
+    // a deployed kNN index, which only the dynamic aggregator picks up
+    bool all_match = true;
+    for (const auto& article : articles) {
+        BiasResult a = dynamic_aggregator.analyze(article);
+        BiasResult b = static_aggregator.analyze(article);
+        all_match = all_match && std::abs(a.score - b.score) < 1e-12 &&
+                    a.label == b.label && a.confidence == b.confidence &&
+                    a.explanations == b.explanations;
+    }
+
+    AnalysisOptions explained;
+    AnalysisOptions scores_only;
+    scores_only.render_explanations = false;
+
+    // Warm both (thread-local scratch contexts, lexicon)
+    nanoseconds_per_article(dynamic_aggregator, articles, scores_only, 1);
+    nanoseconds_per_article(static_aggregator, articles, scores_only, 1);
+
+    double dynamic_explained = nanoseconds_per_article(dynamic_aggregator, articles, explained, rounds);
+    double static_explained = nanoseconds_per_article(static_aggregator, articles, explained, rounds);
+    double dynamic_scores = nanoseconds_per_article(dynamic_aggregator, articles, scores_only, rounds);
+    double static_scores = nanoseconds_per_article(static_aggregator, articles, scores_only, rounds);
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "articles: " << count << ", rounds: " << rounds << "\n"
+              << "                       dynamic   static   (ns/article)\n"
+              << "with explanations:   " << std::setw(9) << dynamic_explained
+              << std::setw(9) << static_explained << "\n"
+              << "scores only:         " << std::setw(9) << dynamic_scores
+              << std::setw(9) << static_scores << "\n"
+              << (all_match ? "results match" : "MISMATCH between aggregators") << std::endl;
+    return all_match ? 0 : 1;
+}
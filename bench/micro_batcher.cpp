@@ -0,0 +1,44 @@
+#include "micro_batcher.hpp"
+#include <algorithm>
+#include <numeric>
+
+std::vector<SequenceBatch> MicroBatcher::plan(const std::vector<uint32_t>& lengths,
+                                              const Limits& limits) {
+    std::vector<uint32_t> order(lengths.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](uint32_t a, uint32_t b) { return lengths[a] < lengths[b]; });
+
+    const size_t max_batch = std::max<size_t>(1, limits.max_batch);
+    std::vector<SequenceBatch> batches;
+    SequenceBatch current;
+    for (uint32_t index : order) {
+        // Sorted ascending, so the new sequence sets the padded length
+        const size_t length = lengths[index];
+        const size_t padded = (current.items.size() + 1) * length;
+        if (!current.items.empty() &&
+            (current.items.size() == max_batch || padded > limits.max_tokens)) {
+            batches.push_back(std::move(current));
+            current = SequenceBatch{};
+        }
+        current.items.push_back(index);
+        current.padded_length = static_cast<uint32_t>(length);
+    }
+    if (!current.items.empty()) {
+        batches.push_back(std::move(current));
+    }
+    return batches;
+}
+
+double MicroBatcher::efficiency(const std::vector<uint32_t>& lengths,
+                                const std::vector<SequenceBatch>& batches) {
+    size_t real = 0;
+    size_t padded = 0;
+    for (const SequenceBatch& batch : batches) {
+        for (uint32_t index : batch.items) {
+            real += lengths[index];
+        }
+        padded += batch.items.size() * batch.padded_length;
+    }
+    return (padded == 0) ? 1.0 : static_cast<double>(real) / static_cast<double>(padded);
+}
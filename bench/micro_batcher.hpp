@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * One model call: the sequences it holds and the length they are padded to.
+ */
+struct SequenceBatch {
+    std::vector<uint32_t> items;  // indices into the planned sequences
+    uint32_t padded_length = 0;   // longest sequence in the batch
+};
+
+/**
+ * MicroBatcher: groups variable-length sequences (sentences from many
+ * articles) into length-bucketed batches for a transformer model.
+ *
+ * A batch is padded to its longest sequence, so mixing a 6-token headline
+ * with a 120-token sentence wastes most of the work. The plan sorts the
+ * sequences by length and cuts consecutive runs into batches, so every
+ * batch holds sequences of nearly the same length. A batch is closed when
+ * it reaches max_batch sequences or its padded size (count x longest)
+ * would exceed max_tokens, which keeps long sentences in small batches and
+ * short ones in wide ones at a roughly constant cost per call.
+ */
+class MicroBatcher {
+public:
+    struct Limits {
+        size_t max_batch = 64;      // sequences per batch
+        size_t max_tokens = 8192;   // padded tokens per batch
+    };
+
+    /**
+     * @param lengths Token count of each sequence
+     * @return Batches covering every index exactly once, shortest first
+     */
+    static std::vector<SequenceBatch> plan(const std::vector<uint32_t>& lengths,
+                                           const Limits& limits);
+
+    static std::vector<SequenceBatch> plan(const std::vector<uint32_t>& lengths) {
+        return plan(lengths, Limits{});
+    }
+
+    /**
+     * Fraction of the padded tokens of a plan that are real tokens (1 = no padding).
+     */
+    static double efficiency(const std::vector<uint32_t>& lengths,
+                             const std::vector<SequenceBatch>& batches);
+};
@@ -0,0 +1,319 @@
+#include "wordpiece_tokenizer.hpp"
+#include "../include/hash.hpp"
+#include <algorithm>
+#include <fstream>
+#include <unordered_set>
+
+namespace {
+
+// Base letter of U+00C0..U+00FF with the accent stripped and lowercased;
+// 0 = no decomposition (Æ, Ð, Ø, Þ, ß, ×, ÷ and their lowercase forms)
+constexpr char kLatin1Base[65] =
+    "aaaaaa\0c" "eeeeiiii" "\0nooooo\0" "\0uuuuy\0\0"
+    "aaaaaa\0c" "eeeeiiii" "\0nooooo\0" "\0uuuuy\0y";
+
+inline bool is_ascii_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// BERT treats every non-alphanumeric printable ASCII character as punctuation
+inline bool is_ascii_punctuation(unsigned char c) {
+    return (c >= 33 && c <= 47) || (c >= 58 && c <= 64) || (c >= 91 && c <= 96) ||
+           (c >= 123 && c <= 126);
+}
+
+inline bool is_unicode_space(uint32_t cp) {
+    return cp == 0xA0 || (cp >= 0x2000 && cp <= 0x200A) || cp == 0x2028 || cp == 0x2029 ||
+           cp == 0x202F || cp == 0x205F || cp == 0x3000;
+}
+
+// The punctuation that shows up in news text: Latin-1 marks, general
+// punctuation (dashes, curly quotes, ellipsis), CJK punctuation
+inline bool is_unicode_punctuation(uint32_t cp) {
+    return cp == 0xA1 || cp == 0xA7 || cp == 0xAB || cp == 0xB6 || cp == 0xB7 || cp == 0xBB ||
+           cp == 0xBF || (cp >= 0x2010 && cp <= 0x2027) || (cp >= 0x2030 && cp <= 0x205E) ||
+           (cp >= 0x3001 && cp <= 0x303F) || (cp >= 0xFF01 && cp <= 0xFF0F);
+}
+
+// CJK ideographs are split into single characters, as BERT does
+inline bool is_cjk(uint32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+           (cp >= 0x20000 && cp <= 0x2A6DF) || (cp >= 0xF900 && cp <= 0xFAFF);
+}
+
+// Decode one UTF-8 sequence at text[i]; invalid bytes decode as themselves
+uint32_t decode_utf8(std::string_view text, size_t i, size_t& length) {
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    size_t n = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+    if (i + n > text.size()) {
+        n = 1;
+    }
+    uint32_t cp = (n == 1) ? c : (n == 2) ? (c & 0x1F) : (n == 3) ? (c & 0x0F) : (c & 0x07);
+    for (size_t k = 1; k < n; ++k) {
+        const unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80) {
+            length = 1;
+            return c;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    length = n;
+    return cp;
+}
+
+void append_utf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+bool is_special(std::string_view piece) {
+    return piece.size() > 2 && piece.front() == '[' && piece.back() == ']';
+}
+
+}  // namespace
+
+bool WordPieceTokenizer::load(const std::string& vocab_path) {
+    std::ifstream file(vocab_path);
+    if (!file.is_open()) {
+        last_error = vocab_path + ": cannot open";
+        return false;
+    }
+    std::vector<std::string> pieces;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        pieces.push_back(line);
+    }
+    if (!load_pieces(pieces)) {
+        last_error = vocab_path + ": " + last_error;
+        return false;
+    }
+    return true;
+}
+
+bool WordPieceTokenizer::load_pieces(const std::vector<std::string>& pieces) {
+    last_error.clear();
+    std::vector<std::string_view> word_keys;
+    std::vector<int64_t> word_ids;
+    std::vector<std::string_view> suffix_keys;
+    std::vector<int64_t> suffix_ids;
+    std::unordered_set<std::string_view> seen_words;
+    std::unordered_set<std::string_view> seen_suffixes;
+
+    int64_t special[4] = {-1, -1, -1, -1};  // [CLS] [SEP] [PAD] [UNK]
+    static const char* const kSpecialNames[4] = {"[CLS]", "[SEP]", "[PAD]", "[UNK]"};
+    bool cased = false;
+    size_t longest = 0;
+
+    for (size_t id = 0; id < pieces.size(); ++id) {
+        std::string_view piece = pieces[id];
+        if (piece.empty()) {
+            continue;
+        }
+        for (size_t s = 0; s < 4; ++s) {
+            if (special[s] < 0 && piece == kSpecialNames[s]) {
+                special[s] = static_cast<int64_t>(id);
+            }
+        }
+        if (!is_special(piece)) {
+            for (char c : piece) {
+                cased = cased || (c >= 'A' && c <= 'Z');
+            }
+        }
+
+        // First occurrence of a piece wins
+        if (piece.size() > 2 && piece.substr(0, 2) == "##") {
+            std::string_view suffix = piece.substr(2);
+            if (seen_suffixes.insert(suffix).second) {
+                suffix_keys.push_back(suffix);
+                suffix_ids.push_back(static_cast<int64_t>(id));
+            }
+            longest = std::max(longest, suffix.size());
+        } else if (seen_words.insert(piece).second) {
+            word_keys.push_back(piece);
+            word_ids.push_back(static_cast<int64_t>(id));
+            longest = std::max(longest, piece.size());
+        }
+    }
+
+    for (size_t s = 0; s < 4; ++s) {
+        if (special[s] < 0) {
+            last_error = std::string("no ") + kSpecialNames[s] + " token";
+            return false;
+        }
+    }
+
+    build(words, word_keys, word_ids);
+    build(suffixes, suffix_keys, suffix_ids);
+    piece_count = pieces.size();
+    max_piece_bytes = longest;
+    lowercase = !cased;
+    cls = special[0];
+    sep = special[1];
+    pad = special[2];
+    unk = special[3];
+    return true;
+}
+
+void WordPieceTokenizer::build(Table& table, const std::vector<std::string_view>& keys,
+                               const std::vector<int64_t>& ids) {
+    std::vector<uint64_t> hashes(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        hashes[i] = hash_bytes(keys[i]);
+    }
+    VocabularyLayout layout = Vocabulary::layout(hashes);
+
+    // Keys in slot order, so Vocabulary id = slot + 1 spans its own bytes
+    table.offsets.assign(static_cast<size_t>(layout.slot_count) + 2, 0);
+    table.piece_id.assign(static_cast<size_t>(layout.slot_count) + 1, -1);
+    table.blob.clear();
+    for (uint32_t id = 1; id <= layout.slot_count; ++id) {
+        table.offsets[id] = static_cast<uint32_t>(table.blob.size());
+        uint32_t key = layout.slot_key[id - 1];
+        if (key != 0) {
+            std::string_view piece = keys[key - 1];
+            table.blob.insert(table.blob.end(), piece.begin(), piece.end());
+            table.piece_id[id] = ids[key - 1];
+        }
+    }
+    table.offsets[static_cast<size_t>(layout.slot_count) + 1] = static_cast<uint32_t>(table.blob.size());
+    table.displacements = std::move(layout.displacements);
+    table.vocabulary = Vocabulary(table.offsets.data(), table.blob.data(), table.displacements.data(),
+                                  layout.slot_count, layout.bucket_count);
+}
+
+int64_t WordPieceTokenizer::lookup(const Table& table, std::string_view piece) {
+    uint32_t id = table.vocabulary.find(piece);
+    return (id == Vocabulary::kUnknown) ? -1 : table.piece_id[id];
+}
+
+void WordPieceTokenizer::tokenize(std::string_view text, size_t max_pieces,
+                                  std::vector<int64_t>& out) const {
+    if (empty()) {
+        return;
+    }
+    const size_t first = out.size();
+    std::string word;
+
+    auto flush = [&] {
+        if (!word.empty()) {
+            word_pieces(word, max_pieces - (out.size() - first), out);
+            word.clear();
+        }
+    };
+
+    size_t i = 0;
+    while (i < text.size() && out.size() - first < max_pieces) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+
+        // ASCII fast path
+        if (c < 0x80) {
+            ++i;
+            if (is_ascii_space(c)) {
+                flush();
+            } else if (c < 0x20 || c == 0x7F) {
+                // Control characters are dropped
+            } else if (is_ascii_punctuation(c)) {
+                flush();
+                word.push_back(static_cast<char>(c));
+                flush();
+            } else {
+                word.push_back((lowercase && c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20)
+                                                                   : static_cast<char>(c));
+            }
+            continue;
+        }
+
+        size_t length;
+        uint32_t cp = decode_utf8(text, i, length);
+        std::string_view bytes = text.substr(i, length);
+        i += length;
+
+        if (is_unicode_space(cp)) {
+            flush();
+        } else if (is_unicode_punctuation(cp) || is_cjk(cp)) {
+            flush();
+            word.append(bytes);
+            flush();
+        } else if (lowercase && cp >= 0xC0 && cp <= 0xFF) {
+            const char base = kLatin1Base[cp - 0xC0];
+            if (base != '\0') {
+                word.push_back(base);
+            } else if (cp <= 0xDE && cp != 0xD7) {
+                append_utf8(cp + 0x20, word);  // Æ -> æ, Ø -> ø, ...
+            } else {
+                word.append(bytes);
+            }
+        } else {
+            word.append(bytes);
+        }
+    }
+    flush();
+
+    if (out.size() - first > max_pieces) {
+        out.resize(first + max_pieces);
+    }
+}
+
+void WordPieceTokenizer::word_pieces(std::string_view word, size_t max_pieces,
+                                     std::vector<int64_t>& out) const {
+    if (max_pieces == 0) {
+        return;
+    }
+    if (word.size() > kMaxWordBytes) {
+        out.push_back(unk);
+        return;
+    }
+
+    // Greedy longest match first; a word with any uncovered stretch is [UNK]
+    const size_t first = out.size();
+    size_t start = 0;
+    while (start < word.size()) {
+        size_t end = std::min(word.size(), start + max_piece_bytes);
+        int64_t found = -1;
+        while (end > start) {
+            // Only cut at UTF-8 character boundaries
+            if (end == word.size() || (static_cast<unsigned char>(word[end]) & 0xC0) != 0x80) {
+                std::string_view piece = word.substr(start, end - start);
+                found = (start == 0) ? lookup(words, piece) : lookup(suffixes, piece);
+                if (found >= 0) {
+                    break;
+                }
+            }
+            --end;
+        }
+        if (found < 0) {
+            out.resize(first);
+            out.push_back(unk);
+            return;
+        }
+        out.push_back(found);
+        start = end;
+    }
+}
+
+void WordPieceTokenizer::encode(std::string_view text, size_t max_length,
+                                std::vector<int64_t>& out) const {
+    out.clear();
+    if (max_length < 2) {
+        return;
+    }
+    out.push_back(cls);
+    tokenize(text, max_length - 2, out);
+    out.push_back(sep);
+}
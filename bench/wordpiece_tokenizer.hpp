@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../include/vocabulary.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * WordPieceTokenizer: BERT-style subword tokenizer, the input side of a
+ * transformer embedding model (DistilBERT, MiniLM and other
+ * BERT-vocabulary models).
+ *
+ * Reads the model's vocab.txt (one piece per line, id = line number).
+ * Text is first split on whitespace and punctuation; for uncased
+ * vocabularies it is also lowercased and Latin-1 accents are stripped.
+ * Each word is then cut greedily into the longest pieces in the vocabulary
+ * ("unaffable" -> "un", "##aff", "##able"); a word that cannot be covered,
+ * or is longer than 100 bytes, becomes [UNK].
+ *
+ * Whole-word pieces and "##" continuations live in two perfect-hashed
+ * Vocabulary tables, so a lookup is one hash and one compare, with no
+ * string building per candidate. Immutable after load; safe to share.
+ */
+class WordPieceTokenizer {
+public:
+    WordPieceTokenizer() = default;
+
+    // Vocabulary views point into the owned tables: movable, not copyable
+    WordPieceTokenizer(const WordPieceTokenizer&) = delete;
+    WordPieceTokenizer& operator=(const WordPieceTokenizer&) = delete;
+    WordPieceTokenizer(WordPieceTokenizer&&) = default;
+    WordPieceTokenizer& operator=(WordPieceTokenizer&&) = default;
+
+    /**
+     * Read a vocab.txt. Casing is detected from the vocabulary: if no
+     * piece outside [SPECIAL] tokens has an uppercase ASCII letter, input
+     * is lowercased.
+     * @return false if unreadable or missing [CLS]/[SEP]/[PAD]/[UNK] (see error())
+     */
+    bool load(const std::string& vocab_path);
+
+    /**
+     * Same from pieces in id order.
+     */
+    bool load_pieces(const std::vector<std::string>& pieces);
+
+    /**
+     * Append the piece ids of text to out, at most max_pieces of them.
+     */
+    void tokenize(std::string_view text, size_t max_pieces, std::vector<int64_t>& out) const;
+
+    /**
+     * Model input for one sequence: [CLS] pieces [SEP], truncated so the
+     * whole sequence has at most max_length ids. out is replaced.
+     */
+    void encode(std::string_view text, size_t max_length, std::vector<int64_t>& out) const;
+
+    bool empty() const { return piece_count == 0; }
+    size_t size() const { return piece_count; }
+    bool lowercases() const { return lowercase; }
+
+    int64_t cls_id() const { return cls; }
+    int64_t sep_id() const { return sep; }
+    int64_t pad_id() const { return pad; }
+    int64_t unk_id() const { return unk; }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    static constexpr size_t kMaxWordBytes = 100;
+
+    // Owned storage behind one Vocabulary view
+    struct Table {
+        std::vector<uint32_t> offsets;
+        std::vector<char> blob;
+        std::vector<uint32_t> displacements;
+        std::vector<int64_t> piece_id;  // Vocabulary id -> model id (-1 = empty slot)
+        Vocabulary vocabulary;
+    };
+
+    Table words;      // pieces that start a word
+    Table suffixes;   // "##" continuations, stored without the prefix
+    size_t piece_count = 0;
+    size_t max_piece_bytes = 0;  // longest piece, bounds the greedy search
+    bool lowercase = true;
+    int64_t cls = -1;
+    int64_t sep = -1;
+    int64_t pad = -1;
+    int64_t unk = -1;
+    std::string last_error;
+
+    static void build(Table& table, const std::vector<std::string_view>& keys,
+                      const std::vector<int64_t>& ids);
+    static int64_t lookup(const Table& table, std::string_view piece);
+
+    // Append the pieces of one pre-split word
+    void word_pieces(std::string_view word, size_t max_pieces, std::vector<int64_t>& out) const;
+};
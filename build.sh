@@ -11,6 +11,29 @@ mkdir -p build
 # Create object files in build/
 clang++ -std=c++17 -I. -c src/nlp_context.cpp -o build/nlp.o
 clang++ -std=c++17 -I. -c src/preprocessor.cpp -o build/prep.o
+clang++ -std=c++17 -I. -c src/sentence_splitter.cpp -o build/sentences.o
+clang++ -std=c++17 -I. -c src/entity_matcher.cpp -o build/entities.o
+clang++ -std=c++17 -I. -c src/mapped_file.cpp -o build/mapped_file.o
+clang++ -std=c++17 -I. -c src/json_reader.cpp -o build/json_reader.o
+clang++ -std=c++17 -I. -c src/article_line_parser.cpp -o build/article_line_parser.o
+clang++ -std=c++17 -I. -c src/vocabulary.cpp -o build/vocabulary.o
+clang++ -std=c++17 -I. -c src/phrase_trie.cpp -o build/phrase_trie.o
+clang++ -std=c++17 -I. -c src/lexicon.cpp -o build/lexicon.o
+clang++ -std=c++17 -I. -c src/lexicon_builder.cpp -o build/lexicon_builder.o
+clang++ -std=c++17 -I. -c src/domain_resolver.cpp -o build/domain_resolver.o
+clang++ -std=c++17 -I. -c src/outlet_table.cpp -o build/outlet_table.o
+clang++ -std=c++17 -I. -c src/outlet_table_builder.cpp -o build/outlet_table_builder.o
+clang++ -std=c++17 -I. -c src/outlet_validator.cpp -o build/outlet_validator.o
+clang++ -std=c++17 -I. -c src/word_embeddings.cpp -o build/word_embeddings.o
+clang++ -std=c++17 -I. -c src/embedding_builder.cpp -o build/embedding_builder.o
+clang++ -std=c++17 -I. -c src/similarity_kernel.cpp -o build/similarity_kernel.o
+clang++ -std=c++17 -I. -c src/wordpiece_tokenizer.cpp -o build/wordpiece_tokenizer.o
+clang++ -std=c++17 -I. -c src/micro_batcher.cpp -o build/micro_batcher.o
+clang++ -std=c++17 -I. -c src/knn_index.cpp -o build/knn_index.o
+clang++ -std=c++17 -I. -c src/knn_index_builder.cpp -o build/knn_index_builder.o
+clang++ -std=c++17 -I. -c src/thread_pool.cpp -o build/thread_pool.o
+clang++ -std=c++17 -I. -c src/result_cache.cpp -o build/result_cache.o
+clang++ -std=c++17 -I. -c src/near_duplicate_index.cpp -o build/near_duplicate_index.o
 clang++ -std=c++17 -I. -c src/bias_aggregator.cpp -o build/agg.o
 clang++ -std=c++17 -I. -c src/signals/outlet_baseline_signal.cpp -o build/outlet.o
 clang++ -std=c++17 -I. -c src/signals/entity_sentiment_signal.cpp -o build/entity.o
@@ -18,17 +41,37 @@ clang++ -std=c++17 -I. -c src/signals/policy_framing_signal.cpp -o build/policy.
 clang++ -std=c++17 -I. -c src/signals/emotional_direction_signal.cpp -o build/emotional.o
 clang++ -std=c++17 -I. -I/opt/homebrew/include -c src/signals/semantic_bias_signal.cpp -o build/semantic.o 2>/dev/null || \
   clang++ -std=c++17 -I. -c src/signals/semantic_bias_signal.cpp -o build/semantic.o
+clang++ -std=c++17 -I. -c src/signals/knn_bias_signal.cpp -o build/knn.o
 
 # Link library
 ar rcs build/libbias_detector.a build/*.o
 
 # Build example
 clang++ -std=c++17 -I. -c example.cpp -o build/example.o
-clang++ -std=c++17 build/example.o build/libbias_detector.a -o build/bias_detector_example 2>/dev/null || \
-  clang++ -std=c++17 build/example.o build/libbias_detector.a -o build/bias_detector_example
+clang++ -std=c++17 build/example.o build/libbias_detector.a -pthread -o build/bias_detector_example 2>/dev/null || \
+  clang++ -std=c++17 build/example.o build/libbias_detector.a -pthread -o build/bias_detector_example
+
+# Build and run the lexicon compiler
+clang++ -std=c++17 -I. tools/lexicon_compiler.cpp build/libbias_detector.a -pthread -o build/bias_lexicon_compiler
+./build/bias_lexicon_compiler config/lexicon build/lexicon.bin
+
+# Build and run the outlet compiler
+clang++ -std=c++17 -I. tools/outlet_compiler.cpp build/libbias_detector.a -pthread -o build/bias_outlet_compiler
+./build/bias_outlet_compiler config/outlets.json build/outlets.bin
+
+# Build the embedding compiler (run it on GloVe/fastText/word2vec vectors)
+clang++ -std=c++17 -I. tools/embedding_compiler.cpp build/libbias_detector.a -pthread -o build/bias_embedding_compiler
+
+# Build the kNN index compiler (run it on a hand-rated article corpus)
+clang++ -std=c++17 -I. tools/knn_index_compiler.cpp build/libbias_detector.a -pthread -o build/bias_knn_compiler
+
+# Build the batch CLI (JSON lines in, JSON lines out)
+clang++ -std=c++17 -I. tools/batch_cli.cpp build/libbias_detector.a -pthread -o build/bias_batch
 
 echo "✓ Compilation successful"
 echo "✓ Executable: ./build/bias_detector_example"
 echo "✓ Library: ./build/libbias_detector.a"
+echo "✓ Lexicon image: ./build/lexicon.bin (copy to config/ to skip compiling at startup)"
+echo "✓ Outlet image: ./build/outlets.bin (copy to config/ to skip parsing outlets.json)"
 echo "✓ Object files: ./build/*.o"
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * ArticleLineParser: one line of newline-delimited JSON into an
+ * ArticleInput, for bulk input (tools/batch_cli).
+ *
+ * A line is an object with string fields "title", "body", "url" and
+ * "domain" (missing or null ones are left empty); other keys are skipped
+ * whatever their values. The line is scanned in place: the closing quote
+ * and any backslash are found with memchr, so a string without escapes is
+ * a single view into the input, copied once into the field. Fields are
+ * reassigned, not rebuilt, so an ArticleInput reused from line to line
+ * keeps its buffers and stops allocating once warm. Escapes (including
+ * \uXXXX surrogate pairs) are decoded during that copy.
+ *
+ * Looser than JsonReader, for speed on trusted dumps: structure, strings
+ * and escapes are checked, numbers and literals of skipped values are only
+ * scanned.
+ */
+class ArticleLineParser {
+public:
+    /**
+     * @param line One JSON object (without the newline; a trailing '\r' is fine)
+     * @param article Receives the four fields (all reassigned)
+     * @return false if the line is not such an object (see error())
+     */
+    bool parse(std::string_view line, ArticleInput& article);
+
+    /**
+     * Raw JSON text of the "id" value of the last parsed line (a view into
+     * that line), empty if it had none; lets output records be joined back.
+     */
+    std::string_view id() const { return id_text; }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    static constexpr size_t kMaxDepth = 64;
+
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    std::string_view id_text;
+    std::string key;           // current key, reused
+    std::string last_error;
+
+    bool fail(const char* message);
+    void skip_whitespace();
+    bool expect(char c);
+
+    // String at pos (opening quote); decoded into out, or skipped if null
+    bool read_string(std::string* out);
+    bool read_hex4(unsigned& code);
+    bool skip_value(size_t depth);
+};
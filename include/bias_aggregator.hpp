@@ -4,6 +4,11 @@
 #include "nlp_context.hpp"
 #include "preprocessor.hpp"
 #include "bias_signal.hpp"
+#include "result_cache.hpp"
+#include "near_duplicate_index.hpp"
+#include "thread_pool.hpp"
+#include <functional>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -24,14 +29,87 @@
  */
 class BiasAggregator {
 public:
+    /**
+     * Registers the built-in signals; KnnBiasSignal only if a kNN index is
+     * deployed (KnnIndex::current() non-empty) when the aggregator is built.
+     */
     BiasAggregator();
 
     /**
      * Main entry point: analyze an article.
+     * Const and reentrant: per-call buffers live in a thread-local NLPContext,
+     * so one aggregator can serve any number of threads at once (configure
+     * weights before sharing it).
      * @param article Raw article input
-     * @return BiasResult with score, label, confidence, and explanations
+     * @param options render_explanations = false skips all string formatting
+     * @return BiasResult with score, label, confidence, per-signal outputs
+     *         and (if requested) explanations
+     */
+    BiasResult analyze(const ArticleInput& article,
+                       const AnalysisOptions& options = {}) const;
+
+    /**
+     * Same, with a caller-owned scratch context (reset on entry).
+     */
+    BiasResult analyze(const ArticleInput& article, NLPContext& scratch,
+                       const AnalysisOptions& options = {}) const;
+
+    /**
+     * Render explanations for a result produced by this aggregator, e.g. one
+     * analyzed with render_explanations = false and picked for audit later.
+     * Needs only the stored result, not the article.
+     */
+    std::vector<std::string> explain(const BiasResult& result) const;
+
+    /**
+     * Analyze a batch across the worker pool. Each worker thread keeps its
+     * own scratch context; results come back in input order and match
+     * analyze() article for article.
+     * @param articles Articles to analyze
+     * @return One BiasResult per article, same order
+     */
+    std::vector<BiasResult> analyze_batch(const std::vector<ArticleInput>& articles,
+                                          const AnalysisOptions& options = {});
+
+    /**
+     * Streaming variant: on_result(index, result) is called as soon as each
+     * article finishes, in completion order. Calls come from worker threads
+     * but never overlap, so the callback needs no locking of its own.
+     */
+    using BatchCallback = std::function<void(size_t index, BiasResult&& result)>;
+    void analyze_batch(const std::vector<ArticleInput>& articles,
+                       const BatchCallback& on_result,
+                       const AnalysisOptions& options = {});
+
+    /**
+     * Number of batch workers (default 0 = one per hardware thread).
+     * The pool is started lazily on the first batch.
      */
-    BiasResult analyze(const ArticleInput& article);
+    void set_thread_count(size_t threads);
+
+    /**
+     * Enable the content-hash result cache with room for this many articles
+     * (0 = disabled, the default). Repeats of the same title and body reuse
+     * the text-only signal outputs; only metadata signals (outlet) are
+     * recomputed. Call before sharing the aggregator between threads.
+     */
+    void set_cache_capacity(size_t entries);
+
+    /**
+     * Hit/miss/eviction counters (all zero when the cache is disabled).
+     */
+    ResultCache::Stats cache_stats() const;
+
+    /**
+     * Reuse analysis across lightly edited copies (tweaked headline, extra
+     * paragraph): an article whose SimHash is within max_distance bits of one
+     * of the last `entries` analyzed articles takes that article's text
+     * signal outputs instead of being preprocessed. Approximate by design;
+     * 0 entries disables it (the default). Call before sharing the aggregator.
+     */
+    void set_near_duplicate_reuse(size_t entries, unsigned max_distance = 6);
+
+    NearDuplicateIndex::Stats near_duplicate_stats() const;
 
     /**
      * Set custom weights for signals (default: predefined weights)
@@ -44,16 +122,48 @@ private:
     Preprocessor preprocessor;
     std::vector<std::unique_ptr<BiasSignal>> signals;
     std::unordered_map<std::string, double> weights;
+    std::vector<size_t> metadata_signals;  // indices with uses_metadata()
+
+    std::unique_ptr<ResultCache> cache;
+    std::unique_ptr<NearDuplicateIndex> near_duplicates;
+
+    // Batch workers (started on first analyze_batch())
+    size_t thread_count = 0;
+    std::unique_ptr<ThreadPool> pool;
+    std::mutex callback_mutex;
+
+    // Both analyze_batch() variants; deliver is called from the workers
+    void run_batch(const std::vector<ArticleInput>& articles, const AnalysisOptions& options,
+                   const BatchCallback& deliver);
+
+    // What finish() needs from the lookups made before preprocessing
+    struct PendingEntry {
+        ResultCache::Key cache_key;
+        uint64_t generation = 0;      // content generation the lookups used
+        uint64_t index_version = 0;   // KnnIndex::version() folded into it
+        uint64_t fingerprint = 0;
+    };
+
+    /**
+     * Steps 0-2: cache and near-duplicate lookups, refusal checks and
+     * preprocessing into scratch. Returns true with result set when the
+     * article was settled without computing signals.
+     */
+    bool settle(const ArticleInput& article, NLPContext& scratch,
+                const AnalysisOptions& options, PendingEntry& pending,
+                BiasResult& result) const;
 
-    // Refusal logic
-    bool insufficient_data(const NLPContext& ctx) const;
+    // Step 3 on: signals of a preprocessed article, cache insert, score
+    BiasResult finish(const ArticleInput& article, const NLPContext& ctx,
+                      const PendingEntry& pending, const AnalysisOptions& options) const;
 
-    // Scoring
-    double compute_confidence(const NLPContext& ctx,
-                             const std::vector<double>& scores) const;
+    // Score a stored entry, recomputing only the metadata signals
+    BiasResult reuse(ResultCache::Entry& entry, const ArticleInput& article,
+                     NLPContext& scratch, const AnalysisOptions& options) const;
 
-    // Bucketing
-    std::string bucket_label(double score) const;
+    // Steps after signal computation: weighted aggregate, confidence, label
+    BiasResult score(std::vector<SignalOutput> outputs, size_t token_count,
+                     size_t entity_count, const AnalysisOptions& options) const;
 
     // Normalize weights to sum to 1.0
     void normalize_weights();
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "types.hpp"
+#include "nlp_context.hpp"
+#include "preprocessor.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * Scoring rules shared by BiasAggregator and StaticBiasAggregator:
+ * refusal threshold, default weights, confidence and label buckets.
+ * Kept inline so the static aggregator can fold them into its scoring loop.
+ */
+
+inline constexpr const char* kInsufficientDataLabel = "Insufficient Data";
+inline constexpr const char* kInsufficientDataExplanation =
+    "Article is too short or has too few entities for reliable analysis";
+
+// Refusal thresholds
+inline constexpr size_t kMinTokens = 100;
+inline constexpr size_t kMinEntities = 1;
+
+/**
+ * Refusal logic: minimum token count and entity count.
+ */
+inline bool insufficient_data(const NLPContext& ctx) {
+    return ctx.token_count() < kMinTokens || ctx.entity_count() < kMinEntities;
+}
+
+/**
+ * The same decision from the raw article, before preprocessing: an exact
+ * token count that stops at kMinTokens, then an entity-presence probe.
+ * Agrees with insufficient_data(ctx) for the context process() would build.
+ */
+inline bool insufficient_data(const Preprocessor& preprocessor, const ArticleInput& article) {
+    static_assert(kMinEntities == 1, "the raw probe only tests for any entity");
+    return preprocessor.count_tokens(article, kMinTokens) < kMinTokens ||
+           !preprocessor.has_entities(article);
+}
+
+/**
+ * The "Insufficient Data" result returned by refusal.
+ */
+inline BiasResult insufficient_data_result(const AnalysisOptions& options) {
+    BiasResult refused{
+        .score = 0.0,
+        .label = kInsufficientDataLabel,
+        .confidence = 0.0
+    };
+    if (options.render_explanations) {
+        refused.explanations.push_back(kInsufficientDataExplanation);
+    }
+    return refused;
+}
+
+/**
+ * Default weight for a built-in signal (before normalization); 0 if unknown.
+ */
+inline double default_signal_weight(std::string_view signal_name) {
+    if (signal_name == "OutletBaseline") return 0.15;
+    if (signal_name == "EntitySentiment") return 0.30;
+    if (signal_name == "PolicyFraming") return 0.20;
+    if (signal_name == "EmotionalDirection") return 0.15;
+    if (signal_name == "SemanticBias") return 0.20;  // New semantic layer
+    if (signal_name == "KnnBias") return 0.20;       // Labeled-corpus neighbors
+    return 0.0;
+}
+
+/**
+ * Confidence in [0, 1] from signal agreement and data quantity.
+ * Abstained signals do not count towards agreement.
+ */
+inline double compute_confidence(size_t token_count, size_t entity_count,
+                                 const SignalOutput* outputs, size_t count) {
+    size_t active = 0;
+    for (size_t i = 0; i < count; ++i) {
+        active += !outputs[i].abstained;
+    }
+    if (active == 0) {
+        return 0.0;
+    }
+
+    // Confidence factors:
+    // 1. Agreement between signals (lower variance = higher confidence)
+    // 2. Data quantity (more entities/tokens = higher confidence)
+    // 3. Entity diversity
+
+    // Calculate signal agreement
+    double score_sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!outputs[i].abstained) {
+            score_sum += outputs[i].score;
+        }
+    }
+    double mean_score = score_sum / active;
+    double variance = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!outputs[i].abstained) {
+            variance += (outputs[i].score - mean_score) * (outputs[i].score - mean_score);
+        }
+    }
+    variance /= active;
+
+    // Agreement: 1 / (1 + variance) bounded to [0, 1]
+    double agreement_confidence = 1.0 / (1.0 + variance);
+
+    // Data quantity: sigmoid on token count and entity count
+    double token_ratio = std::min(1.0, static_cast<double>(token_count) / 1000.0);
+    double entity_ratio = std::min(1.0, static_cast<double>(entity_count) / 10.0);
+    double data_confidence = (token_ratio + entity_ratio) / 2.0;
+
+    // Combined confidence (average)
+    return (agreement_confidence + data_confidence) / 2.0;
+}
+
+/**
+ * Bucket an aggregate score into its label.
+ */
+inline const char* bucket_label(double score) {
+    if (score >= 0.6) {
+        return "Strong Right";
+    } else if (score >= 0.3) {
+        return "Moderate Right";
+    } else if (score >= 0.1) {
+        return "Slight Right";
+    } else if (score > -0.1) {
+        return "Neutral";
+    } else if (score >= -0.3) {
+        return "Slight Left";
+    } else if (score >= -0.6) {
+        return "Moderate Left";
+    } else {
+        return "Strong Left";
+    }
+}
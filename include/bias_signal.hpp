@@ -13,6 +13,10 @@
  * 2. Provide explanation for its reasoning
  * 3. Have a unique name
  * 
+ * Signals are immutable after construction: compute() is const and returns
+ * everything explain() needs, so one instance is safe to share between
+ * threads.
+ *
  * This is the Strategy pattern - each signal is independent and testable.
  */
 class BiasSignal {
@@ -23,18 +27,26 @@ public:
      * Compute the bias score for this signal.
      * @param ctx Shared NLP context
      * @param article Original article input
-     * @return Score in [-1.0, +1.0] where negative = left bias, positive = right bias
+     * @return Score in [-1.0, +1.0] where negative = left bias, positive = right bias,
+     *         plus the figures behind it
      */
-    virtual double compute(const NLPContext& ctx,
-                          const ArticleInput& article) = 0;
+    virtual SignalOutput compute(const NLPContext& ctx,
+                                 const ArticleInput& article) const = 0;
 
     /**
-     * Produce a human-readable explanation of the score.
+     * Produce a human-readable explanation of a result from compute().
      */
-    virtual std::string explain() const = 0;
+    virtual std::string explain(const SignalOutput& output) const = 0;
 
     /**
      * Unique identifier for this signal (used in weighting).
      */
     virtual std::string name() const = 0;
+
+    /**
+     * True if the score depends on article metadata (domain, URL) rather
+     * than only on the text. These are recomputed on result-cache hits,
+     * with an empty context, so they must not read the text from ctx.
+     */
+    virtual bool uses_metadata() const { return false; }
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * DomainResolver: maps a host name to the longest registered domain it
+ * belongs to ("edition.cnn.com" -> "cnn.com", "www.news.com.au" ->
+ * "news.com.au").
+ *
+ * Domains are stored as a trie of reversed labels (com -> cnn -> edition),
+ * so a lookup walks the host from its last label leftwards, one edge per
+ * label, and remembers the deepest registered node it passed. Edges live in
+ * one open-addressed table keyed by (parent node, label hash); a lookup
+ * allocates nothing and folds ASCII case itself.
+ *
+ * Public-suffix rules: top-level labels and the registered public suffixes
+ * ("co.uk", "com.au", "blogspot.com", ...) are never returned as a match,
+ * and a match above a public suffix is discarded, so "someone.blogspot.com"
+ * does not inherit the score of a rated "blogspot.com".
+ *
+ * Build once, then share: resolve() is const and safe to call concurrently.
+ */
+class DomainResolver {
+public:
+    static constexpr uint32_t kNoMatch = 0;
+
+    // Empty resolver with the built-in public suffixes registered
+    DomainResolver();
+
+    /**
+     * Register a domain with a non-zero value returned by resolve().
+     * Re-registering a domain replaces its value.
+     */
+    void add(std::string_view domain, uint32_t value);
+
+    /**
+     * Register a public suffix (a domain under which anyone can register
+     * names, e.g. "co.uk").
+     */
+    void add_public_suffix(std::string_view suffix);
+
+    /**
+     * Value of the longest registered domain that host equals or is a
+     * subdomain of, or kNoMatch. Host is a bare host name (see host_of()).
+     */
+    uint32_t resolve(std::string_view host) const;
+
+    /**
+     * Host part of a URL or bare domain ("https://user@www.cnn.com:443/x?y"
+     * -> "www.cnn.com"), as a view into url. Strips a trailing root dot.
+     */
+    static std::string_view host_of(std::string_view url);
+
+    // Number of registered domains
+    size_t size() const { return domain_total; }
+
+private:
+    struct Node {
+        uint32_t parent = 0;
+        uint32_t label_offset = 0;   // lowercase label bytes in labels
+        uint32_t label_length = 0;
+        uint32_t value = kNoMatch;
+        bool public_suffix = false;
+    };
+
+    struct Edge {
+        uint64_t hash = 0;           // label hash, seeded with the parent
+        uint32_t parent = 0;
+        uint32_t child = 0;          // 0 = empty (the root is never a child)
+    };
+
+    std::vector<Node> nodes;         // nodes[0] is the root
+    std::string labels;
+    std::vector<Edge> edges;         // power-of-two size, at most half full
+    size_t edge_total = 0;
+    size_t domain_total = 0;
+
+    uint32_t child(uint32_t parent, std::string_view label, uint64_t hash) const;
+    uint32_t insert(std::string_view domain);
+    void place(const Edge& edge);
+};
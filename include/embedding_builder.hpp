@@ -0,0 +1,76 @@
+#pragma once
+
+#include "word_embeddings.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * EmbeddingBuilder: collects pretrained word vectors and seed words and
+ * compiles them into the binary image that WordEmbeddings maps.
+ *
+ * Vector sources (words lowercased; the first occurrence of a word wins,
+ * and the files list words by descending frequency):
+ *   GloVe text        word v1 v2 ... vd              (one word per line)
+ *   fastText .vec     "count dim" header, then as GloVe
+ *   word2vec .bin     "count dim" header, then word, space, d raw float32
+ *
+ * Seeds are tab-separated ('#' starts a comment), e.g. config/semantic_seeds.tsv:
+ *   word  reference
+ * Each reference direction is the normalized mean of its seeds' unit vectors.
+ *
+ * Used offline by tools/embedding_compiler.
+ */
+class EmbeddingBuilder {
+public:
+    /**
+     * Read a vector file; the format is picked from its extension (.bin is
+     * word2vec binary, anything else text) and the header line if any.
+     * @param max_words Stop after this many words (0 = all)
+     * @return false on a malformed line or inconsistent dimension (see error())
+     */
+    bool load_vectors(const std::string& path, size_t max_words = 0);
+
+    /**
+     * Read a seed list (word <TAB> reference name).
+     */
+    bool load_seeds(const std::string& path);
+
+    /**
+     * Add a word's vector unless the word is already present.
+     * @return false if values.size() differs from earlier vectors
+     */
+    bool add(std::string_view word, const std::vector<float>& values);
+
+    void add_seed(std::string_view word, std::string_view reference);
+
+    /**
+     * Serialize to the image format described by EmbeddingImageHeader.
+     * References none of whose seeds have a vector are left out.
+     */
+    std::vector<uint8_t> compile(EmbeddingPrecision precision) const;
+
+    size_t word_count() const { return words.size(); }
+    size_t dimension() const { return dim; }
+    size_t seed_count() const { return seeds.size(); }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    struct Seed {
+        std::string word;
+        std::string reference;
+    };
+
+    std::vector<std::string> words;                   // in file (frequency) order
+    std::vector<float> matrix;                        // words.size() x dim
+    std::unordered_map<std::string, uint32_t> index;  // word -> position in words
+    std::vector<Seed> seeds;
+    size_t dim = 0;
+    std::string last_error;
+
+    bool load_text(const std::string& path, size_t max_words);
+    bool load_word2vec(const std::string& path, size_t max_words);
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * EntityMatcher: Aho-Corasick multi-pattern matcher over lowercased text.
+ *
+ * Patterns are added once, compiled with build(), and then every scan()
+ * walks the text a single time regardless of dictionary size. Matches are
+ * only reported on token boundaries (no alphanumeric byte directly before
+ * or after), so "bill" does not fire inside "billion".
+ *
+ * Transitions are stored sparsely (sorted edge lists per state) with a
+ * dense table for the root, which keeps dictionaries of tens of thousands
+ * of names compact while the common "no match" path stays one lookup.
+ */
+class EntityMatcher {
+public:
+    struct Match {
+        uint32_t pattern;  // id passed to add()
+        uint32_t offset;   // byte offset of the match in the scanned text
+        uint32_t length;   // byte length of the match
+    };
+
+    EntityMatcher();
+
+    /**
+     * Register a pattern (ASCII-lowercased on insertion).
+     * Duplicate patterns keep the first id. Must be called before build().
+     */
+    void add(std::string_view pattern, uint32_t id);
+
+    /**
+     * Compute failure links and flatten the automaton. Call once after add().
+     */
+    void build();
+
+    size_t pattern_count() const { return pattern_ids.size(); }
+
+    /**
+     * Scan lowercased text once, invoking on_match(const Match&) for every
+     * boundary-respecting occurrence in order of match end.
+     */
+    template <typename Fn>
+    void scan(std::string_view text, Fn&& on_match) const;
+
+    /**
+     * True if scan() over the ASCII-lowercased text would report at least one
+     * match; folds case itself and stops at the first hit, so it can probe raw
+     * input cheaply. Text is any type with size() and operator[] returning a
+     * char (std::string_view, or a view joining title and body).
+     */
+    template <typename Text>
+    bool contains_any(const Text& text) const;
+
+private:
+    static constexpr uint32_t kRoot = 0;
+    static constexpr uint32_t kNoOutput = UINT32_MAX;
+
+    struct State {
+        uint32_t edge_begin = 0;      // into edge_labels/edge_targets
+        uint32_t edge_count = 0;
+        uint32_t fail = kRoot;        // longest proper suffix state
+        uint32_t output = kNoOutput;  // pattern index ending here
+        uint32_t dict_link = kNoOutput;  // next state on fail chain with an output
+    };
+
+    std::vector<State> states;
+    std::vector<uint8_t> edge_labels;
+    std::vector<uint32_t> edge_targets;
+    uint32_t root_next[256];
+
+    // Per pattern (indexed by State::output)
+    std::vector<uint32_t> pattern_ids;
+    std::vector<uint32_t> pattern_lengths;
+
+    // Trie edges during construction, flattened by build()
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> pending_edges;
+
+    uint32_t step(uint32_t state, uint8_t c) const;
+    uint32_t find_edge(uint32_t state, uint8_t c) const;
+
+    static bool is_word_byte(unsigned char c) {
+        return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+    }
+};
+
+inline uint32_t EntityMatcher::find_edge(uint32_t state, uint8_t c) const {
+    const State& s = states[state];
+    const uint8_t* labels = edge_labels.data() + s.edge_begin;
+    for (uint32_t i = 0; i < s.edge_count; ++i) {
+        if (labels[i] == c) {
+            return edge_targets[s.edge_begin + i];
+        }
+        if (labels[i] > c) {
+            break;
+        }
+    }
+    return kNoOutput;
+}
+
+inline uint32_t EntityMatcher::step(uint32_t state, uint8_t c) const {
+    while (state != kRoot) {
+        uint32_t next = find_edge(state, c);
+        if (next != kNoOutput) {
+            return next;
+        }
+        state = states[state].fail;
+    }
+    return root_next[c];
+}
+
+template <typename Text>
+bool EntityMatcher::contains_any(const Text& text) const {
+    const size_t n = text.size();
+    uint32_t state = kRoot;
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t c = static_cast<uint8_t>(text[i]);
+        if (c >= 'A' && c <= 'Z') {
+            c |= 0x20;
+        }
+        state = step(state, c);
+
+        uint32_t out = (states[state].output != kNoOutput) ? state : states[state].dict_link;
+        if (out == kNoOutput) {
+            continue;
+        }
+
+        // Same boundary rules as scan(); is_word_byte() ignores case
+        if (i + 1 < n && is_word_byte(static_cast<unsigned char>(text[i + 1]))) {
+            continue;
+        }
+
+        for (; out != kNoOutput; out = states[out].dict_link) {
+            size_t begin = i + 1 - pattern_lengths[states[out].output];
+            if (begin == 0 || !is_word_byte(static_cast<unsigned char>(text[begin - 1]))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Fn>
+void EntityMatcher::scan(std::string_view text, Fn&& on_match) const {
+    const size_t n = text.size();
+    uint32_t state = kRoot;
+    for (size_t i = 0; i < n; ++i) {
+        state = step(state, static_cast<uint8_t>(text[i]));
+
+        uint32_t out = (states[state].output != kNoOutput) ? state : states[state].dict_link;
+        if (out == kNoOutput) {
+            continue;
+        }
+
+        // Right boundary is shared by every pattern ending at i
+        if (i + 1 < n && is_word_byte(static_cast<unsigned char>(text[i + 1]))) {
+            continue;
+        }
+
+        for (; out != kNoOutput; out = states[out].dict_link) {
+            uint32_t pattern = states[out].output;
+            uint32_t length = pattern_lengths[pattern];
+            size_t begin = i + 1 - length;
+            if (begin > 0 && is_word_byte(static_cast<unsigned char>(text[begin - 1]))) {
+                continue;
+            }
+            on_match(Match{pattern_ids[pattern], static_cast<uint32_t>(begin), length});
+        }
+    }
+}
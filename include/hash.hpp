@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * Fast non-cryptographic 64-bit hash for short keys (tokens, domains).
+ * Processes 8 bytes per multiply; good avalanche for hash-table use.
+ */
+inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t hash_bytes(const void* data, size_t length, uint64_t seed = 0) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed ^ (0x9E3779B97F4A7C15ULL * (length + 1));
+
+    while (length >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        h = hash_mix(h ^ chunk) * 0x9E3779B97F4A7C15ULL;
+        p += 8;
+        length -= 8;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, length);
+    return hash_mix(h ^ tail ^ (static_cast<uint64_t>(length) << 56));
+}
+
+inline uint64_t hash_bytes(std::string_view text, uint64_t seed = 0) {
+    return hash_bytes(text.data(), text.size(), seed);
+}
+
+/**
+ * ASCII-lowercase the 8 bytes of a word at once (SWAR: no per-byte
+ * branches; bytes >= 0x80 are left alone).
+ */
+inline uint64_t ascii_lower_word(uint64_t word) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    uint64_t heptets = word & (0x7F * ones);
+    uint64_t at_least_a = heptets + (0x80 - 'A') * ones;
+    uint64_t above_z = heptets + (0x80 - 'Z' - 1) * ones;
+    uint64_t is_upper = (at_least_a ^ above_z) & ~word & (0x80 * ones);
+    return word | (is_upper >> 2);
+}
+
+/**
+ * hash_bytes() of the ASCII-lowercased input, without making a lowercase copy.
+ */
+inline uint64_t hash_bytes_folded(const void* data, size_t length, uint64_t seed = 0) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed ^ (0x9E3779B97F4A7C15ULL * (length + 1));
+
+    while (length >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);
+        h = hash_mix(h ^ ascii_lower_word(chunk)) * 0x9E3779B97F4A7C15ULL;
+        p += 8;
+        length -= 8;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, length);
+    return hash_mix(h ^ ascii_lower_word(tail) ^ (static_cast<uint64_t>(length) << 56));
+}
+
+inline uint64_t hash_bytes_folded(std::string_view text, uint64_t seed = 0) {
+    return hash_bytes_folded(text.data(), text.size(), seed);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+/**
+ * Search steps of a hierarchical navigable small world graph (HNSW,
+ * Malkov & Yashunin), shared by KnnIndex (mmapped, read-only) and
+ * KnnIndexBuilder (linking nodes while other threads search).
+ *
+ * A Graph provides:
+ *   size_t size() const;                                     // node count
+ *   float similarity(const float* query, uint32_t id) const; // higher = closer
+ *   void neighbors(uint32_t id, uint32_t level, std::vector<uint32_t>& out) const;
+ */
+
+struct HnswCandidate {
+    float similarity;
+    uint32_t id;
+};
+
+/**
+ * Nodes seen by one search. reset() starts a new search in O(1) by bumping
+ * an epoch instead of clearing the marks.
+ */
+class HnswVisited {
+public:
+    void reset(size_t count) {
+        if (marks.size() < count) {
+            marks.resize(count, 0);
+        }
+        if (++epoch == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    // True the first time id is seen since reset()
+    bool visit(uint32_t id) {
+        if (marks[id] == epoch) {
+            return false;
+        }
+        marks[id] = epoch;
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> marks;
+    uint32_t epoch = 0;
+};
+
+/**
+ * Greedy walk on one level: move to the closest neighbor until none is
+ * closer than the current node.
+ */
+template <typename Graph>
+HnswCandidate hnsw_greedy_descent(const Graph& graph, const float* query, HnswCandidate entry,
+                                  uint32_t level) {
+    static thread_local std::vector<uint32_t> neighbors;
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        graph.neighbors(entry.id, level, neighbors);
+        for (uint32_t id : neighbors) {
+            const float similarity = graph.similarity(query, id);
+            if (similarity > entry.similarity) {
+                entry = HnswCandidate{similarity, id};
+                improved = true;
+            }
+        }
+    }
+    return entry;
+}
+
+/**
+ * Best-first search of one level from entry, keeping the ef closest nodes
+ * found; out receives them closest first.
+ */
+template <typename Graph>
+void hnsw_search_layer(const Graph& graph, const float* query, HnswCandidate entry, size_t ef,
+                       uint32_t level, std::vector<HnswCandidate>& out) {
+    static thread_local HnswVisited visited;
+    static thread_local std::vector<uint32_t> neighbors;
+
+    auto farther = [](const HnswCandidate& a, const HnswCandidate& b) {
+        return a.similarity < b.similarity;
+    };
+    auto closer = [](const HnswCandidate& a, const HnswCandidate& b) {
+        return a.similarity > b.similarity;
+    };
+    // Frontier with the closest node on top; results with the farthest on top
+    std::priority_queue<HnswCandidate, std::vector<HnswCandidate>, decltype(farther)> frontier(farther);
+    std::priority_queue<HnswCandidate, std::vector<HnswCandidate>, decltype(closer)> results(closer);
+
+    ef = std::max<size_t>(ef, 1);
+    visited.reset(graph.size());
+    visited.visit(entry.id);
+    frontier.push(entry);
+    results.push(entry);
+
+    while (!frontier.empty()) {
+        const HnswCandidate current = frontier.top();
+        if (results.size() >= ef && current.similarity < results.top().similarity) {
+            break;  // nothing left on the frontier can improve the results
+        }
+        frontier.pop();
+
+        graph.neighbors(current.id, level, neighbors);
+        for (uint32_t id : neighbors) {
+            if (!visited.visit(id)) {
+                continue;
+            }
+            const float similarity = graph.similarity(query, id);
+            if (results.size() < ef || similarity > results.top().similarity) {
+                frontier.push(HnswCandidate{similarity, id});
+                results.push(HnswCandidate{similarity, id});
+                if (results.size() > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    out.resize(results.size());
+    for (size_t i = out.size(); i-- > 0;) {
+        out[i] = results.top();
+        results.pop();
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Receives JsonReader events in document order. Every callback returns
+ * false to stop parsing (JsonReader::parse() then fails with the handler's
+ * message, see JsonReader::error()). String views are only valid during
+ * the call.
+ */
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    virtual bool start_object() { return true; }
+    virtual bool key(std::string_view) { return true; }
+    virtual bool end_object() { return true; }
+    virtual bool start_array() { return true; }
+    virtual bool end_array() { return true; }
+    virtual bool string(std::string_view) { return true; }
+    virtual bool number(double) { return true; }
+    virtual bool boolean(bool) { return true; }
+    virtual bool null() { return true; }
+
+    // Why the handler stopped (reported by JsonReader::error())
+    const std::string& message() const { return stop_reason; }
+
+protected:
+    bool stop(std::string reason) {
+        stop_reason = std::move(reason);
+        return false;
+    }
+
+private:
+    std::string stop_reason;
+};
+
+/**
+ * JsonReader: streaming (SAX) JSON parser for config files.
+ *
+ * Reads the input in fixed-size chunks and reports each value to a
+ * JsonHandler as it is parsed, so memory stays bounded by the chunk size,
+ * the longest string and the nesting depth, whatever the document size.
+ * Implements RFC 8259: nested containers, all string escapes (\uXXXX
+ * including surrogate pairs, emitted as UTF-8), numbers as double.
+ * Errors carry the line and column of the offending byte.
+ */
+class JsonReader {
+public:
+    /**
+     * @param max_depth Deepest nesting of objects/arrays accepted
+     */
+    explicit JsonReader(size_t max_depth = 256);
+
+    /**
+     * Parse one JSON document (surrounding whitespace allowed).
+     * @return false on a syntax error or if the handler stopped (see error())
+     */
+    bool parse(std::istream& in, JsonHandler& handler);
+    bool parse(std::string_view text, JsonHandler& handler);
+
+    /**
+     * Parse a file; errors are prefixed with its path.
+     */
+    bool parse_file(const std::string& path, JsonHandler& handler);
+
+    // "line:column: message" of the last failure (empty after success)
+    const std::string& error() const { return last_error; }
+    size_t error_line() const { return fail_line; }
+    size_t error_column() const { return fail_column; }
+
+private:
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    size_t depth_limit;
+
+    // Input window: [pos, end) of buffer is unread; in is null for text input
+    std::istream* in = nullptr;
+    std::vector<char> buffer;
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    size_t line = 1;
+    size_t column = 1;
+
+    std::string scratch;   // current string or number text
+    std::string last_error;
+    size_t fail_line = 0;
+    size_t fail_column = 0;
+
+    bool run(JsonHandler& handler);
+    bool parse_value(JsonHandler& handler, size_t depth);
+    bool parse_object(JsonHandler& handler, size_t depth);
+    bool parse_array(JsonHandler& handler, size_t depth);
+    bool parse_string();
+    bool parse_number(double& value);
+    bool parse_literal(const char* word);
+    bool parse_hex4(uint32_t& code);
+
+    bool refill();
+    int peek();
+    int get();
+    void skip_whitespace();
+    bool fail(const std::string& message);
+    bool handler_stopped(const JsonHandler& handler);
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Embedding space the vectors of a kNN index were computed in; queries must
+ * be embedded the same way.
+ */
+enum class KnnSpace : uint32_t {
+    WordVectors = 1,   // WordEmbeddings::embed() of the article's tokens
+};
+
+/**
+ * On-disk layout of a compiled kNN index (little-endian, sections 8-byte
+ * aligned, the vector matrix 64-byte aligned). Written by
+ * KnnIndexBuilder::compile(), read in place by KnnIndex.
+ *
+ * A link list is a count followed by that many node ids, in a block of
+ * fixed capacity: 2m ids on level 0, m on the levels above. Node n's
+ * blocks for levels 1..levels[n] are consecutive, starting at block
+ * upper_offsets[n] of upper_links.
+ */
+struct KnnImageHeader {
+    char magic[8];                // kKnnImageMagic
+    uint32_t version;             // kKnnImageVersion
+    uint32_t dimension;
+    uint32_t count;               // labeled vectors (graph nodes)
+    uint32_t space;               // KnnSpace
+    uint32_t m;                   // link capacity above level 0 (2m on level 0)
+    uint32_t max_level;           // level of the entry point
+    uint32_t entry_point;
+    uint32_t ef_search;           // default search breadth
+    uint64_t embeddings_fingerprint;  // WordEmbeddings::fingerprint() of the vectors used
+    // Section byte offsets from the start of the image
+    uint64_t vectors;             // float[count][dimension], unit length
+    uint64_t ratings;             // float[count], [-1, 1]
+    uint64_t levels;              // uint8_t[count]
+    uint64_t links;               // uint32_t[count][2m + 1], level 0
+    uint64_t upper_offsets;       // uint32_t[count + 1]
+    uint64_t upper_links;         // uint32_t[upper_offsets[count]][m + 1]
+    uint64_t total_size;
+};
+
+constexpr char kKnnImageMagic[8] = {'B', 'D', 'K', 'N', 'N', 'I', 'D', 'X'};
+constexpr uint32_t kKnnImageVersion = 2;
+
+/**
+ * One search result: a labeled vector and its cosine similarity to the query.
+ */
+struct KnnNeighbor {
+    uint32_t id;
+    float similarity;
+};
+
+/**
+ * KnnIndex: approximate nearest-neighbor search over a corpus of articles
+ * with hand-assigned bias ratings, for KnnBiasSignal.
+ *
+ * The corpus is embedded and linked into an HNSW graph offline (see
+ * KnnIndexBuilder and tools/knn_index_compiler); the compiled image holds
+ * the unit vectors, ratings and links and is mmapped, so a 500k-article
+ * index loads without being parsed and search() touches only the pages it
+ * visits: a greedy descent through the sparse upper levels, then a
+ * best-first search of breadth ef on level 0, a few thousand dot products
+ * per query.
+ *
+ * Like WordEmbeddings, current() loads kDefaultImagePath once per process
+ * and reload() swaps in a new version without pausing analysis. When no
+ * index is deployed current() is empty and KnnBiasSignal abstains.
+ */
+class KnnIndex {
+public:
+    static constexpr const char* kDefaultImagePath = "config/knn_index.bin";
+
+    // Empty index: no vectors, search() finds nothing
+    KnnIndex() = default;
+
+    KnnIndex(const KnnIndex&) = delete;
+    KnnIndex& operator=(const KnnIndex&) = delete;
+
+    /**
+     * Process-wide index, loaded on first use from kDefaultImagePath (empty
+     * if none is deployed).
+     */
+    static std::shared_ptr<const KnnIndex> current();
+
+    // Version number of the current process-wide index (+1 per publish)
+    static uint64_t version();
+
+    static void publish(std::shared_ptr<const KnnIndex> index);
+
+    /**
+     * Load kDefaultImagePath again and publish it.
+     * @return false if it could not be loaded (the current version is kept)
+     */
+    static bool reload();
+
+    /**
+     * Map a compiled image from disk.
+     * @return false if missing or invalid (the current index is kept)
+     */
+    bool load(const std::string& image_path);
+
+    /**
+     * Adopt an image compiled in memory (KnnIndexBuilder::compile()).
+     * @return false if invalid (the current index is kept)
+     */
+    bool load_image(std::vector<uint8_t> image);
+
+    bool empty() const { return total == 0; }
+    size_t size() const { return total; }
+    size_t dimension() const { return dim; }
+    KnnSpace space() const { return embedding_space; }
+    size_t default_ef() const { return ef_default; }
+
+    // WordEmbeddings::fingerprint() of the vectors the corpus was embedded with
+    uint64_t embeddings_fingerprint() const { return model_fingerprint; }
+
+    float rating(uint32_t id) const { return ratings[id]; }
+    const float* vector(uint32_t id) const { return vectors + static_cast<size_t>(id) * dim; }
+
+    /**
+     * The k labeled vectors most similar to query (dimension() floats, any
+     * length; zero finds nothing), most similar first.
+     * @param ef Search breadth (raised to k); larger is slower and more exact
+     * @return Number written to out (at most k)
+     */
+    size_t search(const float* query, size_t k, size_t ef, KnnNeighbor* out) const;
+
+    size_t search(const float* query, size_t k, KnnNeighbor* out) const {
+        return search(query, k, ef_default, out);
+    }
+
+    // Graph access for hnsw_search.hpp
+    float similarity(const float* query, uint32_t id) const;
+    void neighbors(uint32_t id, uint32_t level, std::vector<uint32_t>& out) const;
+
+private:
+    MappedFile file;                // backing storage when loaded from disk
+    std::vector<uint8_t> owned;     // backing storage when compiled in memory
+
+    const float* vectors = nullptr;
+    const float* ratings = nullptr;
+    const uint32_t* links = nullptr;
+    const uint32_t* upper_offsets = nullptr;
+    const uint32_t* upper_links = nullptr;
+    uint32_t dim = 0;
+    uint32_t total = 0;
+    uint32_t link_capacity = 0;     // m
+    uint32_t max_level = 0;
+    uint32_t entry_point = 0;
+    uint32_t ef_default = 0;
+    uint64_t model_fingerprint = 0;
+    KnnSpace embedding_space = KnnSpace::WordVectors;
+
+    static bool validate(const uint8_t* data, size_t size);
+    void attach(const uint8_t* data);
+};
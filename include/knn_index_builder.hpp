@@ -0,0 +1,68 @@
+#pragma once
+
+#include "knn_index.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * KnnIndexBuilder: collects labeled article embeddings and links them into
+ * the HNSW graph that KnnIndex maps.
+ *
+ * Each node gets a random top level (geometric, 1/ln(m) scale) and is
+ * linked on every level up to it to the closest nodes a search of breadth
+ * ef_construction finds, pruned by the HNSW neighbor heuristic: a candidate
+ * is kept only if it is closer to the new node than to any neighbor kept
+ * before it, so links spread across clusters instead of piling into one.
+ * Nodes are inserted in parallel with one lock per node; the graph is
+ * therefore not bit-identical between runs with several threads.
+ *
+ * Used offline by tools/knn_index_compiler.
+ */
+class KnnIndexBuilder {
+public:
+    struct Options {
+        size_t m = 16;                 // links per node above level 0 (2m on level 0)
+        size_t ef_construction = 200;  // search breadth while linking
+        size_t ef_search = 64;         // default query breadth stored in the image
+        size_t threads = 0;            // 0 = std::thread::hardware_concurrency()
+        uint64_t seed = 2024;          // level assignment
+    };
+
+    /**
+     * @param embeddings_fingerprint WordEmbeddings::fingerprint() of the
+     *        vectors the articles are embedded with (checked before search)
+     */
+    KnnIndexBuilder(size_t dimension, KnnSpace space, uint64_t embeddings_fingerprint = 0);
+
+    /**
+     * Add a labeled vector (dimension() floats, normalized here).
+     * @param rating Hand-assigned bias in [-1, 1] (clamped)
+     * @return false for a zero or non-finite vector (see error())
+     */
+    bool add(const float* vector, float rating);
+
+    /**
+     * Build the graph and serialize it to the image format described by
+     * KnnImageHeader.
+     * @return Empty if nothing was added
+     */
+    std::vector<uint8_t> compile(const Options& options) const;
+
+    std::vector<uint8_t> compile() const { return compile(Options{}); }
+
+    size_t size() const { return ratings.size(); }
+    size_t dimension() const { return dim; }
+    KnnSpace space() const { return embedding_space; }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    size_t dim;
+    KnnSpace embedding_space;
+    uint64_t model_fingerprint;
+    std::vector<float> vectors;   // size() x dim, unit length
+    std::vector<float> ratings;
+    std::string last_error;
+};
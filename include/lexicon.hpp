@@ -0,0 +1,166 @@
+#pragma once
+
+#include "types.hpp"
+#include "vocabulary.hpp"
+#include "entity_matcher.hpp"
+#include "phrase_trie.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Features a single word contributes to the lexical signals.
+ * A word can carry several at once ("wonderful" is both positive and emotional).
+ * Stored verbatim in the compiled lexicon image, hence the fixed layout.
+ */
+struct LexiconEntry {
+    float sentiment = 0.0f;           // polarity in [-1, 1], 0 = not a sentiment word
+    float emotion = 0.0f;             // emotional intensity added per occurrence
+    int8_t frame_direction = 0;       // policy frame: -1 left, +1 right, 0 none
+    uint8_t frame_weight = 0;         // policy frame strength
+    uint8_t context = 0;              // LexiconContext bits (framing amplifiers)
+    int8_t semantic_dimension = -1;   // SemanticBias embedding slot, -1 none
+    float semantic_weight = 0.0f;     // contribution to that slot (+ left, - right)
+};
+static_assert(sizeof(LexiconEntry) == 16, "LexiconEntry is part of the image format");
+static_assert(std::is_trivially_copyable<LexiconEntry>::value, "LexiconEntry is mapped from disk");
+
+// LexiconEntry::context bits
+enum LexiconContext : uint8_t {
+    kNegativeContext = 1 << 0,  // amplifies a frame it precedes ("dangerous regulation")
+    kPositiveContext = 1 << 1,  // amplifies a frame it follows ("reform benefits")
+};
+
+/**
+ * On-disk layout of a compiled lexicon (little-endian, sections 8-byte aligned).
+ * Written by LexiconBuilder::compile(), read in place by Lexicon.
+ */
+struct LexiconImageHeader {
+    char magic[8];                // kLexiconImageMagic
+    uint32_t version;             // kLexiconImageVersion
+    uint32_t slot_count;          // perfect-hash slots; word ids are 1..slot_count
+    uint32_t bucket_count;        // perfect-hash buckets
+    uint32_t phrase_slot_count;   // phrase trie edge slots (power of two, or 0)
+    uint32_t entity_count;
+    uint32_t reserved;
+    // Section byte offsets from the start of the image
+    uint64_t word_offsets;        // uint32_t[slot_count + 2]
+    uint64_t word_blob;           // char[]
+    uint64_t displacements;       // uint32_t[bucket_count]
+    uint64_t entries;             // LexiconEntry[slot_count + 1]
+    uint64_t phrase_edges;        // PhraseEdge[phrase_slot_count], open-addressed
+    uint64_t entity_offsets;      // uint32_t[entity_count + 1]
+    uint64_t entity_blob;         // char[]
+    uint64_t entity_ideologies;   // Ideology[entity_count], one byte each
+    uint64_t total_size;
+};
+
+constexpr char kLexiconImageMagic[8] = {'B', 'D', 'L', 'E', 'X', 'I', 'M', 'G'};
+constexpr uint32_t kLexiconImageVersion = 2;
+
+/**
+ * Lexicon: the unified word list behind sentiment, emotion, policy framing,
+ * semantic dimensions and entity extraction.
+ *
+ * All tables live in one compiled, read-only image (see LexiconBuilder and
+ * tools/lexicon_compiler). The image is mmapped, so startup does no parsing
+ * and every worker process shares the same pages; lookups read it in place.
+ *
+ * Every word is interned in the image's perfect-hashed Vocabulary; the
+ * Preprocessor maps tokens to ids while tokenizing, and every feature table
+ * is dense and indexed by that id (slot 0, the unknown word, carries no
+ * features), so tagging a token is one array index instead of a string hash.
+ */
+class Lexicon {
+public:
+    static constexpr const char* kDefaultImagePath = "config/lexicon.bin";
+    static constexpr const char* kDefaultSourceDir = "config/lexicon";
+
+    // Empty lexicon: no words, no entities
+    Lexicon();
+
+    Lexicon(const Lexicon&) = delete;
+    Lexicon& operator=(const Lexicon&) = delete;
+
+    /**
+     * Process-wide lexicon, loaded on first use from kDefaultImagePath, or
+     * compiled in memory from kDefaultSourceDir if no image is present.
+     * Hold the snapshot for as long as ids taken from it are in use (the
+     * Preprocessor pins one per article in NLPContext::lexicon); lock-free
+     * after the calling thread's first use of each version.
+     * @param version Receives the version number of the snapshot
+     */
+    static std::shared_ptr<const Lexicon> current();
+    static std::shared_ptr<const Lexicon> current(uint64_t& version);
+
+    // Version number of the current process-wide lexicon (+1 per publish)
+    static uint64_t version();
+
+    /**
+     * Make lexicon the process-wide one. Analyses already running finish on
+     * the previous version; later ones use the new one.
+     */
+    static void publish(std::shared_ptr<const Lexicon> lexicon);
+
+    /**
+     * Load kDefaultImagePath (or compile kDefaultSourceDir) again and
+     * publish it. Call from a maintenance thread; analysis is not paused.
+     * @return false if neither could be loaded (the current version is kept)
+     */
+    static bool reload();
+
+    /**
+     * Map a compiled image from disk.
+     * @return false if missing or invalid (the current tables are kept)
+     */
+    bool load(const std::string& image_path);
+
+    /**
+     * Adopt an image compiled in memory (LexiconBuilder::compile()).
+     * @return false if invalid (the current tables are kept)
+     */
+    bool load_image(std::vector<uint8_t> image);
+
+    /**
+     * Token vocabulary shared by the tokenizer and every id-indexed table.
+     */
+    const Vocabulary& vocabulary() const { return vocab; }
+
+    /**
+     * Features of a token id (Vocabulary::kUnknown yields an empty entry).
+     */
+    const LexiconEntry& entry(uint32_t id) const { return entries[id]; }
+
+    /**
+     * Multiword frames (two to PhraseTrie::kMaxWords words) over token ids.
+     */
+    const PhraseTrie& phrases() const { return phrase_trie; }
+
+    size_t size() const { return vocab.size(); }
+
+    // Entity dictionary; EntityMatcher pattern ids index these
+    const EntityMatcher& entity_matcher() const { return matcher; }
+    size_t entity_count() const { return entity_total; }
+    std::string_view entity_name(uint32_t index) const;
+    Ideology entity_ideology(uint32_t index) const { return entity_ideologies[index]; }
+
+private:
+    MappedFile file;                // backing storage when loaded from disk
+    std::vector<uint8_t> owned;     // backing storage when compiled in memory
+
+    Vocabulary vocab;
+    const LexiconEntry* entries = nullptr;
+    PhraseTrie phrase_trie;
+    const uint32_t* entity_offsets = nullptr;
+    const char* entity_blob = nullptr;
+    const Ideology* entity_ideologies = nullptr;
+    uint32_t entity_total = 0;
+    EntityMatcher matcher;
+
+    static bool validate(const uint8_t* data, size_t size);
+    void attach(const uint8_t* data);
+};
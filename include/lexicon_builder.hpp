@@ -0,0 +1,79 @@
+#pragma once
+
+#include "lexicon.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * LexiconBuilder: collects lexicon data and compiles it into the binary
+ * image that Lexicon maps (perfect-hashed vocabulary + dense feature table).
+ *
+ * Source data is a directory of tab-separated files ('#' starts a comment):
+ *   sentiment.tsv  word  polarity
+ *   emotion.tsv    word  intensity
+ *   frames.tsv     phrase  left|right  weight     (one to five words)
+ *   context.tsv    word  negative|positive
+ *   semantic.tsv   word  dimension  weight
+ *   entities.tsv   name  left|right|neutral
+ *
+ * Used offline by tools/lexicon_compiler and, as a fallback, at startup
+ * when no compiled image is available.
+ */
+class LexiconBuilder {
+public:
+    /**
+     * Read every known file present in a source directory.
+     * @return false on a malformed line or if no file was found (see error())
+     */
+    bool load_directory(const std::string& dir);
+
+    /**
+     * Feature record of a word, created empty on first use.
+     */
+    LexiconEntry& word(std::string_view word);
+
+    /**
+     * Add or replace a multiword frame (2 to PhraseTrie::kMaxWords words).
+     */
+    void add_phrase(const std::vector<std::string_view>& phrase_words,
+                    int8_t direction, uint8_t weight);
+
+    void add_entity(std::string_view name, Ideology ideology);
+
+    /**
+     * Serialize to the image format described by LexiconImageHeader.
+     */
+    std::vector<uint8_t> compile() const;
+
+    size_t word_count() const { return words.size(); }
+    size_t phrase_count() const { return phrases.size(); }
+    size_t entity_count() const { return entities.size(); }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    struct Phrase {
+        std::vector<uint32_t> words;   // indices into words
+        LexiconPhrase frame;
+    };
+
+    struct Entity {
+        std::string name;
+        Ideology ideology;
+    };
+
+    std::vector<std::string> words;
+    std::vector<LexiconEntry> features;               // parallel to words
+    std::unordered_map<std::string, uint32_t> index;  // word -> position in words
+    std::vector<Phrase> phrases;
+    std::map<std::vector<uint32_t>, uint32_t> phrase_index;  // words -> position in phrases
+    std::vector<Entity> entities;
+    std::string last_error;
+
+    uint32_t intern(std::string_view word);
+    bool fail(const std::string& path, size_t line, const std::string& message);
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * MappedFile: read-only view of a whole file.
+ *
+ * Uses mmap where available so every process mapping the same file shares
+ * one copy in the page cache; elsewhere it falls back to reading the file
+ * into an owned buffer. Either way data() stays valid until the object is
+ * destroyed (moves keep the same address).
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Map a file read-only.
+     * @return true on success; on failure the object is left empty
+     */
+    bool open(const std::string& path);
+
+    void close();
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool is_open() const { return bytes != nullptr; }
+
+    /**
+     * Hint that the file will be read front to back, so the kernel reads
+     * ahead aggressively. No-op for the owned-buffer fallback.
+     */
+    void advise_sequential() const;
+
+    /**
+     * Drop the whole pages inside [offset, offset + count) from this
+     * process's resident set once they have been consumed, so a single pass
+     * over a file larger than memory stays bounded. The bytes remain
+     * readable (from the page cache or disk). No-op without mmap.
+     */
+    void release(size_t offset, size_t count) const;
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false;            // true: munmap on close, false: owned buffer
+    std::vector<uint8_t> buffer;    // fallback storage
+};
+
+/**
+ * Replace the file at path with data without ever exposing a partial file:
+ * the bytes are written to path + ".tmp", flushed to disk, and the
+ * temporary is renamed over path. Processes that have the old file mapped
+ * keep reading the old inode (truncating it in place would fault them), and
+ * a reload at any moment sees either the old or the new image.
+ * @return false if any step failed; path is then left as it was
+ */
+bool write_file_atomically(const std::string& path, const std::vector<uint8_t>& data);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "types.hpp"
+#include "result_cache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * NearDuplicateIndex: finds previously analyzed articles whose text is almost
+ * the same (tweaked headline, extra paragraph, changed byline).
+ *
+ * Each article gets a 64-bit SimHash over overlapping 3-token shingles of its
+ * title and body (tokens split and case folded like the Preprocessor's).
+ * Small edits change few shingles and therefore flip few fingerprint bits.
+ * Lookup uses banded LSH: the fingerprint is cut into max_distance + 1
+ * bands, and any fingerprint within max_distance bits must match at least
+ * one band exactly (pigeonhole). Every true neighbour is found while only a
+ * handful of candidates are compared.
+ *
+ * The index is bounded: once full, the oldest entry is replaced (FIFO).
+ * Every method is safe to call concurrently.
+ */
+class NearDuplicateIndex {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    /**
+     * @param capacity Number of articles remembered
+     * @param max_distance Largest Hamming distance (bits of 64) that counts
+     *        as a near duplicate; clamped to 15
+     */
+    NearDuplicateIndex(size_t capacity, unsigned max_distance = 6);
+
+    /**
+     * SimHash fingerprint of an article's title and body.
+     */
+    static uint64_t fingerprint(const ArticleInput& article);
+
+    /**
+     * Copy the entry of the closest indexed article within max_distance
+     * that was analyzed with this content generation (Entry::generation).
+     * @return true if one was found
+     */
+    bool find(uint64_t fingerprint, uint64_t generation, ResultCache::Entry& out);
+
+    /**
+     * Remember an analyzed article (replaces the oldest entry when full).
+     */
+    void insert(uint64_t fingerprint, ResultCache::Entry entry);
+
+    unsigned max_distance() const { return distance_limit; }
+
+    Stats stats() const;
+
+private:
+    struct Slot {
+        uint64_t fingerprint = 0;
+        bool used = false;
+        ResultCache::Entry entry;
+    };
+
+    unsigned distance_limit;
+    unsigned band_count;
+    unsigned band_bits;
+
+    mutable std::mutex mutex;
+    std::vector<Slot> slots;
+    size_t next_slot = 0;  // FIFO replacement cursor
+    size_t used_slots = 0;
+
+    // Per band: band value -> (fingerprint, generation, slot) of entries with
+    // that value; kept inline so candidates are compared without touching
+    // the slots
+    struct Candidate {
+        uint64_t fingerprint;
+        uint64_t generation;
+        uint32_t slot;
+    };
+    std::vector<std::unordered_map<uint64_t, std::vector<Candidate>>> bands;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    uint64_t band_value(uint64_t fingerprint, unsigned band) const;
+};
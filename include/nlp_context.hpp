@@ -1,35 +1,201 @@
 #pragma once
 
 #include "types.hpp"
+#include <cstdint>
+#include <memory>
 #include <vector>
-#include <unordered_map>
 #include <string>
+#include <string_view>
+
+class Lexicon;
+class WordEmbeddings;
+
+/**
+ * Byte range inside NLPContext::text.
+ * Offsets instead of string_views so the context stays safe to copy and move.
+ */
+struct TextSpan {
+    uint32_t offset;
+    uint32_t length;
+};
+
+/**
+ * Left/right totals of a per-entity value (see EntityTable::totals_by_ideology).
+ */
+struct IdeologyTotals {
+    double left = 0.0;
+    double right = 0.0;
+    uint32_t left_count = 0;
+    uint32_t right_count = 0;
+};
+
+/**
+ * Entities found in an article, as struct-of-arrays.
+ *
+ * Per distinct entity (index e): ideology byte, sentiment, emotion and the
+ * entity's id in the Lexicon's entity table (its interned name). Per
+ * mention (index m): owning entity and byte span in NLPContext::text.
+ * Per-ideology reductions run over contiguous columns without branches.
+ */
+struct EntityTable {
+    // Per entity
+    std::vector<Ideology> ideology;
+    std::vector<float> sentiment;      // [-1.0, +1.0]
+    std::vector<float> emotion;        // [0.0, 1.0] - intensity
+    std::vector<uint32_t> name_id;     // Lexicon::entity_name(name_id[e])
+
+    // Per mention, in text order
+    std::vector<uint32_t> mention_entity;  // index e
+    std::vector<TextSpan> mention_span;
+
+    size_t size() const { return ideology.size(); }
+    size_t mention_count() const { return mention_entity.size(); }
+
+    /**
+     * Record a mention, creating the entity on its first occurrence.
+     * @return the entity index
+     */
+    uint32_t add_mention(uint32_t name, Ideology entity_ideology, TextSpan span);
+
+    // Drop all entities and mentions, keeping capacity
+    void clear();
+
+    /**
+     * Sum value(e) over left and right entities and count them.
+     * Accumulates in fixed lanes with 0/1 masks so the loop vectorizes.
+     */
+    template <typename ValueFn>
+    IdeologyTotals totals_by_ideology(ValueFn&& value) const;
+
+private:
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+    std::vector<uint32_t> slot_by_name;  // name id -> entity index, for de-duplication
+};
+
+template <typename ValueFn>
+IdeologyTotals EntityTable::totals_by_ideology(ValueFn&& value) const {
+    constexpr size_t kLanes = 8;
+    float left[kLanes] = {};
+    float right[kLanes] = {};
+    uint32_t left_count[kLanes] = {};
+    uint32_t right_count[kLanes] = {};
+
+    const Ideology* tags = ideology.data();
+    const size_t n = size();
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            uint32_t is_left = tags[i + lane] == Ideology::Left;
+            uint32_t is_right = tags[i + lane] == Ideology::Right;
+            float v = value(i + lane);
+            left[lane] += static_cast<float>(is_left) * v;
+            right[lane] += static_cast<float>(is_right) * v;
+            left_count[lane] += is_left;
+            right_count[lane] += is_right;
+        }
+    }
+    for (size_t lane = 0; i < n; ++i, ++lane) {
+        uint32_t is_left = tags[i] == Ideology::Left;
+        uint32_t is_right = tags[i] == Ideology::Right;
+        float v = value(i);
+        left[lane] += static_cast<float>(is_left) * v;
+        right[lane] += static_cast<float>(is_right) * v;
+        left_count[lane] += is_left;
+        right_count[lane] += is_right;
+    }
+
+    IdeologyTotals totals;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        totals.left += left[lane];
+        totals.right += right[lane];
+        totals.left_count += left_count[lane];
+        totals.right_count += right_count[lane];
+    }
+    return totals;
+}
+
+/**
+ * Per-token lexical features in columnar form (index i = token i).
+ * Filled by the Preprocessor in one pass over the tokens; see LexiconEntry.
+ */
+struct TokenFeatures {
+    std::vector<float> sentiment;            // polarity, 0 = none
+    std::vector<float> emotion;              // intensity, 0 = none
+    std::vector<int8_t> frame_direction;     // -1 left, +1 right, 0 none
+    std::vector<uint8_t> frame_weight;
+    std::vector<uint8_t> context;            // LexiconContext bits
+    std::vector<int8_t> semantic_dimension;  // -1 none
+    std::vector<float> semantic_weight;
+
+    // Size every column to n tokens with "no feature" values
+    void reset(size_t n);
+};
 
 /**
  * Central shared state for NLP analysis.
  * Avoids recomputing expensive NLP operations.
+ *
+ * Every member is a flat buffer, so one context can be reused across
+ * articles: reset() (or Preprocessor::process(article, ctx)) clears the
+ * contents but keeps the capacity, and a warmed-up context processes
+ * further articles without touching the heap.
  */
 class NLPContext {
 public:
-    // Tokenized words
-    std::vector<std::string> tokens;
+    // Lowercased "title + ' ' + body"; tokens and sentences are spans into it
+    std::string text;
 
-    // Sentences (splitted from body)
-    std::vector<std::string> sentences;
+    // Tokenized words (no per-token allocation, see token())
+    std::vector<TextSpan> tokens;
 
-    // Extracted entities and their properties
-    std::vector<EntityMention> entities;
+    // Vocabulary id per token (parallel to tokens; Vocabulary::kUnknown if unseen)
+    std::vector<uint32_t> token_ids;
 
-    // Cached sentiment scores (text -> score)
-    std::unordered_map<std::string, double> sentiment_cache;
+    // hash_bytes() of each token (parallel to tokens), so tables keyed by
+    // word other than the lexicon's (e.g. WordEmbeddings) need not re-hash
+    std::vector<uint64_t> token_hashes;
+
+    // Lexical features per token (parallel to tokens)
+    TokenFeatures features;
+
+    // Sentences (splitted from body), as spans into text
+    std::vector<TextSpan> sentences;
+
+    // Extracted entities, their properties and every mention
+    EntityTable entities;
+
+    // Lexicon version the token ids, features and entity ids refer to; pinned
+    // by Preprocessor::process() so a reload cannot change it mid-article
+    std::shared_ptr<const Lexicon> lexicon;
+    uint64_t lexicon_version = 0;
+
+    // Word vectors pinned the same way (an empty table if none is deployed)
+    std::shared_ptr<const WordEmbeddings> embeddings;
+    uint64_t embeddings_version = 0;
+
+    // WordEmbeddings::embed() of the tokens, shared by the vector-space
+    // signals; empty when no word vectors are deployed
+    std::vector<float> embedding;
+
+    // Cosine of embedding against each reference direction of embeddings,
+    // when the caller scored a whole batch in one kernel call (else empty)
+    std::vector<float> reference_similarity;
+
+    // Clear all analysis state, keeping allocated capacity for the next article
+    void reset();
 
     // Query methods
     size_t token_count() const;
     size_t entity_count() const;
     size_t sentence_count() const;
 
-    // Utility
-    void add_entity(const EntityMention& entity);
-    void cache_sentiment(const std::string& text, double score);
-    double get_cached_sentiment(const std::string& text) const;
+    // Token i as a view into text (valid while the context is alive and unmodified)
+    std::string_view token(size_t i) const {
+        return std::string_view(text.data() + tokens[i].offset, tokens[i].length);
+    }
+
+    // Sentence i as a view into text (lowercased, like the tokens)
+    std::string_view sentence(size_t i) const {
+        return std::string_view(text.data() + sentences[i].offset, sentences[i].length);
+    }
 };
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "vocabulary.hpp"
+#include "domain_resolver.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * On-disk layout of a compiled outlet table (little-endian, sections 8-byte
+ * aligned). Written by OutletTableBuilder::compile(), read in place by OutletTable.
+ */
+struct OutletImageHeader {
+    char magic[8];                // kOutletImageMagic
+    uint32_t version;             // kOutletImageVersion
+    uint32_t slot_count;          // perfect-hash slots; outlet ids are 1..slot_count
+    uint32_t bucket_count;        // perfect-hash buckets
+    uint32_t outlet_count;
+    // Section byte offsets from the start of the image
+    uint64_t domain_offsets;      // uint32_t[slot_count + 2]
+    uint64_t domain_blob;         // char[]
+    uint64_t displacements;       // uint32_t[bucket_count]
+    uint64_t scores;              // double[slot_count + 1], slot 0 = 0.0 (unknown)
+    uint64_t total_size;
+};
+
+constexpr char kOutletImageMagic[8] = {'B', 'D', 'O', 'U', 'T', 'L', 'E', 'T'};
+constexpr uint32_t kOutletImageVersion = 1;
+
+/**
+ * OutletTable: immutable domain -> bias score table for OutletBaselineSignal.
+ *
+ * Domains are interned in a perfect-hashed Vocabulary and scores sit in a
+ * dense array indexed by its ids, so a lookup is one hash and one compare;
+ * unknown domains map to id 0, whose score is neutral (0.0). resolve()
+ * additionally maps hosts and URLs ("https://edition.cnn.com/...") to the
+ * longest rated domain through a DomainResolver built when the table loads.
+ *
+ * Like Lexicon, the table lives in one compiled image (see OutletTableBuilder
+ * and tools/outlet_compiler) that is mmapped, so startup does no JSON
+ * parsing. current() loads it once per process and every aggregator reads the
+ * same copy; reload() swaps in a new version without pausing analysis.
+ */
+class OutletTable {
+public:
+    static constexpr const char* kDefaultImagePath = "config/outlets.bin";
+    static constexpr const char* kDefaultSourcePath = "config/outlets.json";
+
+    // Empty table: every domain is unknown
+    OutletTable();
+
+    OutletTable(const OutletTable&) = delete;
+    OutletTable& operator=(const OutletTable&) = delete;
+
+    /**
+     * Process-wide table, loaded on first use from kDefaultImagePath, or
+     * compiled in memory from kDefaultSourcePath if no image is present.
+     * Lock-free after the calling thread's first use of each version.
+     */
+    static std::shared_ptr<const OutletTable> current();
+
+    // Version number of the current process-wide table (+1 per publish)
+    static uint64_t version();
+
+    /**
+     * Make table the process-wide one. Lookups already running finish on
+     * the previous version; later ones use the new one.
+     */
+    static void publish(std::shared_ptr<const OutletTable> table);
+
+    /**
+     * Load kDefaultImagePath (or parse kDefaultSourcePath) again and publish
+     * it, e.g. after the outlet validator regenerated outlets.json. Call from
+     * a maintenance thread; analysis is not paused.
+     * @return false if neither could be loaded (the current version is kept)
+     */
+    static bool reload();
+
+    /**
+     * Map a compiled image from disk.
+     * @return false if missing or invalid (the current table is kept)
+     */
+    bool load(const std::string& image_path);
+
+    /**
+     * Adopt an image compiled in memory (OutletTableBuilder::compile()).
+     * @return false if invalid (the current table is kept)
+     */
+    bool load_image(std::vector<uint8_t> image);
+
+    /**
+     * Bias score of an exact domain; 0.0 (neutral) if unknown.
+     */
+    double score(std::string_view domain) const { return scores[domains.find(domain)]; }
+
+    /**
+     * Bias score of an outlet id (find()/resolve()); kUnknown yields 0.0.
+     */
+    double score(uint32_t id) const { return scores[id]; }
+
+    /**
+     * Id of an exact domain, or Vocabulary::kUnknown.
+     */
+    uint32_t find(std::string_view domain) const { return domains.find(domain); }
+
+    /**
+     * Id of the longest rated domain a host or URL belongs to ("www.cnn.com",
+     * "https://m.cnn.com/x" -> "cnn.com"), or Vocabulary::kUnknown. Case
+     * insensitive; does not allocate.
+     */
+    uint32_t resolve(std::string_view host_or_url) const {
+        return resolver.resolve(DomainResolver::host_of(host_or_url));
+    }
+
+    std::string_view domain(uint32_t id) const { return domains.word(id); }
+
+    bool contains(std::string_view domain) const { return domains.find(domain) != Vocabulary::kUnknown; }
+
+    // Number of outlets in the table
+    size_t size() const { return outlet_total; }
+
+private:
+    MappedFile file;                // backing storage when loaded from disk
+    std::vector<uint8_t> owned;     // backing storage when compiled in memory
+
+    Vocabulary domains;
+    const double* scores = nullptr;
+    uint32_t outlet_total = 0;
+    DomainResolver resolver;        // host -> outlet id, built from domains
+
+    static bool validate(const uint8_t* data, size_t size);
+    void attach(const uint8_t* data);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "outlet_table.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * OutletTableBuilder: collects outlet ratings and compiles them into the
+ * binary image that OutletTable maps.
+ *
+ * Source data is the "outlets" object of config/outlets.json:
+ *   { "outlets": { "foxnews.com": 0.6, "cnn.com": -0.4, ... } }
+ * A member may also be an object with a "score" field, as in the merged
+ * file OutletValidator writes.
+ *
+ * Used offline by tools/outlet_compiler and, as a fallback, at startup when
+ * no compiled image is available.
+ */
+class OutletTableBuilder {
+public:
+    /**
+     * Read the "outlets" object of a JSON file.
+     * @return false if unreadable or no outlet was found (see error())
+     */
+    bool load_json(const std::string& path);
+
+    /**
+     * Stream the "outlets" object of a JSON file, calling on_outlet for
+     * every member in file order (duplicates included).
+     * @return false on a parse error or if there is no "outlets" object;
+     *         error then holds "path:line:column: message"
+     */
+    static bool read_json(const std::string& path,
+                          const std::function<void(std::string_view, double)>& on_outlet,
+                          std::string& error);
+
+    /**
+     * Add or replace the score of a domain.
+     */
+    void add(std::string_view domain, double score);
+
+    /**
+     * Serialize to the image format described by OutletImageHeader.
+     */
+    std::vector<uint8_t> compile() const;
+
+    size_t outlet_count() const { return domains.size(); }
+
+    const std::string& error() const { return last_error; }
+
+private:
+    std::vector<std::string> domains;
+    std::vector<double> scores;                       // parallel to domains
+    std::unordered_map<std::string, uint32_t> index;  // domain -> position in domains
+    std::string last_error;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * OutletValidator: cross-checks the AllSides and MBFC outlet ratings and
+ * merges them into one outlets file.
+ *
+ * Inputs (all streamed with JsonReader):
+ *   name_to_domain_mapping.json  { "name_to_domain": { "CNN": "cnn.com", ... } }
+ *   allsides_outlets.json        { "outlets": { "CNN": -0.4, ... } }
+ *   mbfc_outlets.json            { "outlets": { "cnn.com": -0.5, ... } }
+ *
+ * AllSides uses outlet names; load the name mapping first so they are
+ * normalized to domains before comparison.
+ */
+class OutletValidator {
+public:
+    struct ValidationResult {
+        std::string outlet;
+        double allsides_score;        // NAN if not rated by AllSides
+        double mbfc_score;            // NAN if not rated by MBFC
+        double score_diff;
+        double agreement_confidence;
+        std::string status;           // agreement, slight_diff, major_diff, only_allsides, only_mbfc
+    };
+
+    struct Statistics {
+        size_t total_outlets;
+        size_t in_both;
+        size_t only_allsides;
+        size_t only_mbfc;
+        size_t strong_agreement;      // diff < 0.1
+        size_t moderate_agreement;    // diff 0.1 - 0.3
+        size_t major_disagreement;    // diff >= 0.3
+    };
+
+    OutletValidator();
+
+    /**
+     * Load the outlet name -> domain mapping.
+     * @return false if unreadable, malformed or empty (see error())
+     */
+    bool load_name_mapping(const std::string& config_path);
+
+    /**
+     * Load AllSides ratings, normalizing names through the mapping.
+     */
+    bool load_allsides(const std::string& config_path);
+
+    /**
+     * Load MBFC ratings.
+     */
+    bool load_mbfc(const std::string& config_path);
+
+    /**
+     * Compare the loaded datasets; results are sorted by outlet.
+     */
+    std::vector<ValidationResult> validate();
+
+    Statistics get_statistics() const;
+
+    void generate_report(const std::string& output_path);
+
+    /**
+     * Write the merged ratings in the config/outlets.json format.
+     */
+    void generate_merged_outlets(const std::string& output_path);
+
+    // "path:line:column: message" of the last failed load
+    const std::string& error() const { return last_error; }
+
+private:
+    std::unordered_map<std::string, std::string> name_to_domain;
+    std::unordered_map<std::string, double> allsides_outlets;
+    std::unordered_map<std::string, double> mbfc_outlets;
+    std::vector<ValidationResult> validation_results;
+    std::string last_error;
+
+    bool parse_outlets_json(const std::string& config_path,
+                            std::unordered_map<std::string, double>& outlets);
+    std::string get_status(const ValidationResult& result);
+    double calculate_confidence(const ValidationResult& result);
+};
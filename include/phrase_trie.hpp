@@ -0,0 +1,106 @@
+#pragma once
+
+#include "hash.hpp"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A multiword policy frame ("free market", "death tax"), matched on
+ * consecutive tokens.
+ */
+struct LexiconPhrase {
+    int8_t frame_direction = 0;   // -1 left, +1 right, 0 = prefix of a longer phrase only
+    uint8_t frame_weight = 0;
+};
+
+/**
+ * One trie edge: following token from state leads to state to. The frame
+ * is that of the phrase spelled by the path ending in to.
+ * Stored verbatim in the compiled lexicon image.
+ */
+struct PhraseEdge {
+    uint32_t from;                // word id (first word) or an inner state
+    uint32_t token;               // word id of the next word
+    uint32_t to;                  // 0 marks an empty table slot
+    LexiconPhrase frame;
+    uint8_t padding[2];
+};
+static_assert(sizeof(PhraseEdge) == 16, "PhraseEdge is part of the image format");
+static_assert(std::is_trivially_copyable<PhraseEdge>::value, "PhraseEdge is mapped from disk");
+
+/**
+ * PhraseTrie: multiword frames as a trie over token ids, as a read-only
+ * view over a compiled lexicon image (see LexiconBuilder).
+ *
+ * The state after a phrase's first word is that word's id; deeper states
+ * are numbered past the vocabulary. Edges live in one open-addressed table
+ * keyed by (state, next token id), so extending a match by one token is a
+ * hash and usually a single probe, whatever the number of phrases. Walking
+ * from every token finds all phrases (up to kMaxWords long) in one pass
+ * without allocating.
+ *
+ * Holds no memory of its own; safe to share between threads.
+ */
+class PhraseTrie {
+public:
+    static constexpr size_t kMaxWords = 5;
+
+    // Empty trie: no phrases
+    PhraseTrie() = default;
+
+    /**
+     * @param edges slot_count edge slots (a power of two, or 0)
+     */
+    PhraseTrie(const PhraseEdge* edges, uint32_t slot_count)
+        : edges(edges), mask(slot_count == 0 ? 0 : slot_count - 1) {}
+
+    /**
+     * Edge leaving state along token, or nullptr.
+     */
+    const PhraseEdge* step(uint32_t state, uint32_t token) const {
+        if (edges == nullptr) {
+            return nullptr;
+        }
+        for (uint32_t i = slot_of(state, token, mask); edges[i].to != 0; i = (i + 1) & mask) {
+            if (edges[i].from == state && edges[i].token == token) {
+                return &edges[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Call on_phrase(const LexiconPhrase&, size_t word_count) for every
+     * phrase that starts at ids[begin], shortest first.
+     */
+    template <typename Fn>
+    void match(const uint32_t* ids, size_t count, size_t begin, Fn&& on_phrase) const {
+        uint32_t state = ids[begin];
+        const size_t limit = (count - begin < kMaxWords) ? count - begin : kMaxWords;
+        for (size_t length = 2; length <= limit; ++length) {
+            const PhraseEdge* edge = step(state, ids[begin + length - 1]);
+            if (edge == nullptr) {
+                return;
+            }
+            if (edge->frame.frame_direction != 0) {
+                on_phrase(edge->frame, length);
+            }
+            state = edge->to;
+        }
+    }
+
+    /**
+     * Place edges (distinct (from, token) pairs) into an open-addressed
+     * table at most half full; the result's size is the slot count.
+     */
+    static std::vector<PhraseEdge> layout(const std::vector<PhraseEdge>& edges);
+
+    static uint32_t slot_of(uint32_t state, uint32_t token, uint32_t mask) {
+        return static_cast<uint32_t>(hash_mix((static_cast<uint64_t>(state) << 32) | token)) & mask;
+    }
+
+private:
+    const PhraseEdge* edges = nullptr;
+    uint32_t mask = 0;
+};
@@ -2,6 +2,7 @@
 
 #include "types.hpp"
 #include "nlp_context.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,9 +12,14 @@
  * Responsibilities:
  * - Tokenization
  * - Sentence splitting
+ * - Lexical feature tagging (one lexicon lookup per token)
  * - Entity extraction
  * - Sentiment computation
+ * - Document embedding (when word vectors are deployed)
  * 
+ * Stateless: all per-article data lives in the NLPContext, so one instance
+ * can serve any number of threads.
+ *
  * Can be extended with better NLP models (spaCy bindings, etc.)
  */
 class Preprocessor {
@@ -21,21 +27,49 @@ public:
     /**
      * Main entry point: processes an article and returns populated NLPContext
      */
-    NLPContext process(const ArticleInput& article);
+    NLPContext process(const ArticleInput& article) const;
+
+    /**
+     * Same, into a caller-owned context that is reset first. Reusing one
+     * context per worker keeps its buffers, so after warm-up an article is
+     * processed with no heap allocations.
+     */
+    void process(const ArticleInput& article, NLPContext& ctx) const;
+
+    /**
+     * Number of tokens process() would produce for this article, counted
+     * over the raw bytes without building anything. Stops once limit is
+     * reached, so checking a minimum length costs only the first few
+     * hundred bytes.
+     */
+    size_t count_tokens(const ArticleInput& article, size_t limit = SIZE_MAX) const;
+
+    /**
+     * Whether process() would extract at least one entity, probed over the
+     * raw title and body (case folded on the fly, stops at the first hit).
+     */
+    bool has_entities(const ArticleInput& article) const;
 
 private:
-    // Tokenization: simple whitespace-based for MVP
-    std::vector<std::string> tokenize(const std::string& text);
+    // Tokenization: lowercases title + body into ctx.text and records
+    // whitespace-delimited words (punctuation trimmed) as spans into it
+    void tokenize(NLPContext& ctx, const ArticleInput& article) const;
 
-    // Sentence splitting: simple regex for MVP
-    std::vector<std::string> split_sentences(const std::string& text);
+    // Sentence splitting: boundary scan over the body (see SentenceSplitter)
+    void split_sentences(NLPContext& ctx, const ArticleInput& article) const;
+
+    // Look each token up once in the Lexicon and fill ctx.features
+    void tag_tokens(NLPContext& ctx) const;
 
     // Extract named entities (stub for now)
-    void extract_entities(NLPContext& ctx, const ArticleInput& article);
+    void extract_entities(NLPContext& ctx, const ArticleInput& article) const;
+
+    // Compute sentiment per entity from the tagged features
+    void compute_sentiment(NLPContext& ctx) const;
 
-    // Compute sentiment per sentence/entity
-    void compute_sentiment(NLPContext& ctx);
+    // Compute emotion scores from the tagged features
+    void compute_emotion(NLPContext& ctx) const;
 
-    // Compute emotion scores
-    void compute_emotion(NLPContext& ctx);
+    // Weighted word-vector sum of the tokens into ctx.embedding
+    void embed(NLPContext& ctx) const;
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * Published<T>: the current version of a read-mostly object (lexicon,
+ * outlet table) that can be replaced while readers keep working.
+ *
+ * A writer builds the new object off the hot path and publish()es it; the
+ * version counter is bumped and readers switch on their next acquire().
+ * Readers that still hold the old snapshot finish on it, and it is freed
+ * when the last of them lets go.
+ *
+ * acquire() is lock-free in the steady state: each thread caches the last
+ * snapshot it saw together with its version and only compares one atomic
+ * counter. The mutex is taken by publish() and by the first acquire() of a
+ * thread after each publish. A thread's cached snapshot stays alive until
+ * that thread acquires again (or exits).
+ */
+template <typename T>
+class Published {
+public:
+    using Snapshot = std::shared_ptr<const T>;
+
+    explicit Published(Snapshot initial)
+        : value(std::move(initial)), owner_id(next_owner_id()) {}
+
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    /**
+     * Replace the current version; in-flight readers keep the old one.
+     */
+    void publish(Snapshot next) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            value.swap(next);
+            current_version.fetch_add(1, std::memory_order_release);
+        }
+        // next (the old version) is released outside the lock
+    }
+
+    /**
+     * Current snapshot; version receives the number it was published as.
+     */
+    Snapshot acquire(uint64_t& version) const {
+        Cache& cache = thread_cache();
+        if (cache.owner != owner_id ||
+            cache.version != current_version.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache.value = value;
+            cache.version = current_version.load(std::memory_order_relaxed);
+            cache.owner = owner_id;
+        }
+        version = cache.version;
+        return cache.value;
+    }
+
+    Snapshot acquire() const {
+        uint64_t version;
+        return acquire(version);
+    }
+
+    // Number of the current version (starts at 1, +1 per publish())
+    uint64_t version() const { return current_version.load(std::memory_order_acquire); }
+
+private:
+    // One entry per thread and T; owner tells instances of the same T apart
+    struct Cache {
+        uint64_t owner = 0;
+        uint64_t version = 0;
+        Snapshot value;
+    };
+
+    mutable std::mutex mutex;          // publish() and cache refills only
+    Snapshot value;
+    std::atomic<uint64_t> current_version{1};
+    const uint64_t owner_id;
+
+    static Cache& thread_cache() {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    static uint64_t next_owner_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * ResultCache: bounded, thread-safe cache of content analysis keyed by a
+ * hash of the article text.
+ *
+ * Syndicated wire copy and re-crawled URLs repeat the same title and body
+ * under many domains. The cache stores everything that depends only on the
+ * text (signal outputs, token and entity counts, the refusal decision) so a
+ * repeat costs one hash over the text plus the metadata-dependent signals.
+ *
+ * The key is the text as the Preprocessor sees it: title and body, ASCII
+ * case folded, plus the content generation (the versions of every table a
+ * text signal reads: lexicon, word vectors, kNN index), so entries computed
+ * before a reload of any of them are never hit again and age out. The map
+ * is split into independently locked shards with LRU eviction per shard, so
+ * concurrent analyze() calls rarely contend.
+ *
+ * Case folding is exact, not a heuristic: every signal reads the
+ * Preprocessor's lowercased text, so case variants analyze identically.
+ * Besides the 64-bit hash that places an entry, each entry keeps a second,
+ * independently seeded hash of the text that must match on lookup, so a
+ * collision of the first never returns another article's outputs.
+ */
+class ResultCache {
+public:
+    struct Entry {
+        bool refused = false;           // "Insufficient Data"; counts/outputs unused
+        uint32_t token_count = 0;
+        uint32_t entity_count = 0;
+        std::vector<SignalOutput> outputs{};  // aggregator signal order
+        uint64_t generation = 0;              // content generation the outputs were computed with
+    };
+
+    // Identifies a text: hash places the entry, check verifies it
+    struct Key {
+        uint64_t hash = 0;
+        uint64_t check = 0;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    /**
+     * @param capacity Maximum number of entries (split evenly across shards)
+     * @param shard_count Number of independently locked shards (rounded up to a power of two)
+     */
+    explicit ResultCache(size_t capacity, size_t shard_count = 16);
+
+    /**
+     * Cache key for an article's text (title + body, case folded) as
+     * analyzed with a given content generation.
+     */
+    static Key key_for(const ArticleInput& article, uint64_t generation = 0);
+
+    /**
+     * Copy the entry for key into out and mark it most recently used.
+     * @return true on a hit (same hash and same check)
+     */
+    bool lookup(const Key& key, Entry& out);
+
+    /**
+     * Insert or replace the entry for key's hash, evicting the least
+     * recently used entry of its shard when full.
+     */
+    void insert(const Key& key, Entry entry);
+
+    Stats stats() const;
+    void clear();
+
+private:
+    struct Node {
+        Key key;
+        Entry entry;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Node> lru;  // front = most recent
+        std::unordered_map<uint64_t, std::list<Node>::iterator> index;  // by key.hash
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    uint32_t shard_shift = 64;  // top bits of the key pick the shard
+
+    Shard& shard_for(uint64_t key) {
+        return *shards[shard_shift >= 64 ? 0 : key >> shard_shift];
+    }
+};
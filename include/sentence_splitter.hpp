@@ -0,0 +1,30 @@
+#pragma once
+
+#include "nlp_context.hpp"
+#include <string_view>
+#include <vector>
+
+/**
+ * SentenceSplitter: linear-time sentence boundary scanner.
+ *
+ * A boundary is a run of '.', '!' or '?' (plus any closing quotes/brackets)
+ * followed by whitespace or end of text. A single '.' is not a boundary when
+ * it belongs to a decimal ("3.5"), a known abbreviation ("Mr.", "U.S."),
+ * or an initial ("J. Smith"); an ellipsis only ends a sentence when the next
+ * word starts with an uppercase letter or an opening quote. Trailing text
+ * without terminal punctuation is emitted as a final sentence.
+ *
+ * No regex, no recursion, no per-sentence allocation: results are spans.
+ */
+class SentenceSplitter {
+public:
+    /**
+     * Append sentence spans of text to out.
+     * @param text Source text (original casing is used for heuristics)
+     * @param base_offset Added to every span offset, so spans can address a
+     *        larger buffer that contains text (e.g. NLPContext::text)
+     * @param out Receives whitespace-trimmed sentence spans
+     */
+    static void split(std::string_view text, uint32_t base_offset,
+                      std::vector<TextSpan>& out);
+};
@@ -9,15 +9,11 @@
  * High emotion + left entity negative sentiment = left bias
  * High emotion + right entity negative sentiment = right bias
  */
-class EmotionalDirectionSignal : public BiasSignal {
+class EmotionalDirectionSignal final : public BiasSignal {
 public:
-    double compute(const NLPContext& ctx,
-                  const ArticleInput& article) override;
+    SignalOutput compute(const NLPContext& ctx,
+                         const ArticleInput& article) const override;
 
-    std::string explain() const override;
+    std::string explain(const SignalOutput& output) const override;
     std::string name() const override { return "EmotionalDirection"; }
-
-private:
-    double left_emotion = 0.0;
-    double right_emotion = 0.0;
 };
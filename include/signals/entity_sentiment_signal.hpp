@@ -9,15 +9,11 @@
  * Left entities with negative sentiment = left bias signal
  * Right entities with negative sentiment = right bias signal
  */
-class EntitySentimentSignal : public BiasSignal {
+class EntitySentimentSignal final : public BiasSignal {
 public:
-    double compute(const NLPContext& ctx,
-                  const ArticleInput& article) override;
+    SignalOutput compute(const NLPContext& ctx,
+                         const ArticleInput& article) const override;
 
-    std::string explain() const override;
+    std::string explain(const SignalOutput& output) const override;
     std::string name() const override { return "EntitySentiment"; }
-
-private:
-    double left_avg = 0.0;
-    double right_avg = 0.0;
 };
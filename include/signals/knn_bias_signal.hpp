@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../bias_signal.hpp"
+#include <cstddef>
+
+/**
+ * Signal 6: kNN Bias
+ *
+ * Rates an article by the hand-assigned ratings of the most similar
+ * articles in a labeled corpus (KnnIndex, config/knn_index.bin): the
+ * article is embedded in the index's space (see KnnSpace), its kNeighbors
+ * nearest neighbors are found in the HNSW graph, and the score is their
+ * ratings averaged by cosine similarity (dissimilar neighbors count for
+ * nothing). left and right are the leftward and rightward parts of that
+ * average (score = right - left).
+ *
+ * Abstains, and so leaves the aggregate and confidence untouched, when no
+ * index is deployed, when the word vectors it was built from are not the
+ * ones loaded (the index records their fingerprint), or when no neighbor is
+ * similar at all.
+ */
+class KnnBiasSignal final : public BiasSignal {
+public:
+    static constexpr size_t kNeighbors = 10;
+
+    SignalOutput compute(const NLPContext& ctx, const ArticleInput& article) const override;
+    std::string explain(const SignalOutput& output) const override;
+    std::string name() const override { return "KnnBias"; }
+};
@@ -1,35 +1,44 @@
 #pragma once
 
 #include "../bias_signal.hpp"
-#include <unordered_map>
+#include "../outlet_table.hpp"
+#include <memory>
 
 /**
  * Signal 1: Outlet Baseline
  * 
  * Based on known outlet bias (domain reputation).
- * Example: outlets.push_back({"foxnews.com", 0.6});  // right-leaning
+ * Example: "foxnews.com": 0.6 in config/outlets.json  // right-leaning
+ *
+ * The article's domain (or, failing that, the host of its url) is resolved
+ * to the longest rated domain, so "www.foxnews.com" and
+ * "https://edition.cnn.com/..." score as their outlets.
+ *
+ * Scores come from the process-wide OutletTable::current(), so constructing
+ * the signal (and every aggregator holding one) does no file I/O, and a
+ * reloaded table is picked up by the next article.
  */
-class OutletBaselineSignal : public BiasSignal {
+class OutletBaselineSignal final : public BiasSignal {
 public:
     OutletBaselineSignal();
 
     /**
-     * Load outlet biases from JSON file
+     * Use a private table loaded from a JSON file instead of the shared one
      * @param config_path Path to outlets.json
-     * @return true if loaded successfully, false otherwise
+     * @return true if loaded successfully, false otherwise (the current table is kept)
      */
     bool load_from_json(const std::string& config_path);
 
-    double compute(const NLPContext& ctx,
-                  const ArticleInput& article) override;
+    SignalOutput compute(const NLPContext& ctx,
+                         const ArticleInput& article) const override;
 
-    std::string explain() const override;
+    std::string explain(const SignalOutput& output) const override;
     std::string name() const override { return "OutletBaseline"; }
+    bool uses_metadata() const override { return true; }
 
 private:
-    // Domain -> bias score
-    std::unordered_map<std::string, double> outlet_scores;
-    double last_score = 0.0;
+    // Private table set by load_from_json(); null = the process-wide one
+    std::shared_ptr<const OutletTable> own_outlets;
 
-    double get_outlet_score(const std::string& domain) const;
+    double get_outlet_score(const OutletTable& outlets, const ArticleInput& article) const;
 };
@@ -8,16 +8,16 @@
  * Detects which policy language appears more frequently.
  * Left-aligned terms: "inequality", "climate action", "regulation"
  * Right-aligned terms: "freedom", "deregulation", "free market"
+ *
+ * Frames of one to five words come from config/lexicon/frames.tsv; the
+ * multiword ones are compiled into the lexicon's PhraseTrie and matched
+ * over token ids in the same single pass that counts the single words.
  */
-class PolicyFramingSignal : public BiasSignal {
+class PolicyFramingSignal final : public BiasSignal {
 public:
-    double compute(const NLPContext& ctx,
-                  const ArticleInput& article) override;
+    SignalOutput compute(const NLPContext& ctx,
+                         const ArticleInput& article) const override;
 
-    std::string explain() const override;
+    std::string explain(const SignalOutput& output) const override;
     std::string name() const override { return "PolicyFraming"; }
-
-private:
-    int left_terms = 0;
-    int right_terms = 0;
 };
@@ -3,37 +3,35 @@
 #include "../bias_signal.hpp"
 #include <vector>
 #include <memory>
+#include <string_view>
 
 /**
  * Signal: Semantic Bias Detection using Vector Spaces
  * 
  * Creates left-wing and right-wing semantic vectors from political terminology.
  * Compares article content to these reference vectors using cosine similarity.
- * 
- * Future: Will integrate ONNX Runtime to use distilbert embeddings
+ *
+ * With pretrained word vectors deployed (WordEmbeddings, config/embeddings.bin)
+ * the article embedding is the weighted average of its token vectors and the
+ * references are built from seed terms (config/semantic_seeds.tsv). Without
+ * them it falls back to the lexicon's 20 hand-assigned semantic dimensions.
  */
-class SemanticBiasSignal : public BiasSignal {
+class SemanticBiasSignal final : public BiasSignal {
 public:
     SemanticBiasSignal();
     ~SemanticBiasSignal();
 
-    double compute(const NLPContext& ctx, const ArticleInput& article) override;
-    std::string explain() const override;
+    SignalOutput compute(const NLPContext& ctx, const ArticleInput& article) const override;
+    std::string explain(const SignalOutput& output) const override;
     std::string name() const override { return "SemanticBias"; }
 
 private:
-    // Reference vectors
-    std::vector<float> left_vector;   // Average embedding of left-wing terms
-    std::vector<float> right_vector;  // Average embedding of right-wing terms
+    // Reference vectors, one row of embedding_dim each (SimilarityKernel axes)
+    std::vector<float> reference_axes;  // row 0: left-wing terms, row 1: right-wing terms
     int embedding_dim = 20;
 
     // Internal methods
-    std::vector<float> embed_text(const std::string& text);
-    double cosine_similarity(const std::vector<float>& a, const std::vector<float>& b);
-    std::vector<std::string> extract_nouns_verbs(const NLPContext& ctx);
+    std::vector<float> embed_text(const NLPContext& ctx) const;
+    std::vector<std::string_view> extract_nouns_verbs(const NLPContext& ctx) const;
     void build_reference_vectors();
-
-    // Tracking
-    double last_left_similarity = 0.0;
-    double last_right_similarity = 0.0;
 };
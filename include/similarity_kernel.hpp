@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SimilarityKernel: cosine similarity of a batch of vectors against a
+ * matrix of reference axes, in one call.
+ *
+ * out[b * axis_count + a] = cos(rows[b], axes[a]) for row-major
+ * rows (batch x dim) and axes (axis_count x dim); 0 where either vector
+ * is (near) zero. Every row is read once per block of four axes, and the
+ * four dot products share its loads (a register-blocked GEMM with the
+ * norms folded in), so scoring many axes costs little more than one.
+ *
+ * The instruction set is picked once at runtime: AVX-512, AVX2+FMA+F16C, or a
+ * portable scalar loop. Accumulates in float; results agree with the
+ * scalar kernel to float rounding.
+ */
+class SimilarityKernel {
+public:
+    enum class Isa {
+        Scalar,
+        Avx2,      // AVX2 + FMA + F16C, 8 lanes
+        Avx512,    // AVX-512F, 16 lanes
+    };
+
+    static void cosine(const float* rows, size_t batch,
+                       const float* axes, size_t axis_count,
+                       size_t dim, float* out);
+
+    /**
+     * Same with a given instruction set (for benchmarks and cross-checks);
+     * unsupported ones fall back to Scalar.
+     */
+    static void cosine(Isa isa, const float* rows, size_t batch,
+                       const float* axes, size_t axis_count,
+                       size_t dim, float* out);
+
+    /**
+     * Plain dot product of two vectors, with the same dispatch (for unit
+     * vectors, where it is the cosine; used by the kNN graph search).
+     */
+    static float dot(const float* a, const float* b, size_t dim);
+
+    /**
+     * out[0..dim) += scale * x, with the same dispatch; the binary16
+     * overload widens eight or sixteen lanes per instruction (F16C or
+     * AVX-512) instead of converting element by element.
+     */
+    static void accumulate(float scale, const float* x, size_t dim, float* out);
+    static void accumulate(float scale, const uint16_t* x, size_t dim, float* out);
+
+    // Best instruction set of this CPU (detected once)
+    static Isa best();
+
+    static bool supported(Isa isa);
+    static const char* name(Isa isa);
+};
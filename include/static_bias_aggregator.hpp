@@ -0,0 +1,189 @@
+#pragma once
+
+#include "types.hpp"
+#include "nlp_context.hpp"
+#include "preprocessor.hpp"
+#include "bias_scoring.hpp"
+#include "signals/outlet_baseline_signal.hpp"
+#include "signals/entity_sentiment_signal.hpp"
+#include "signals/policy_framing_signal.hpp"
+#include "signals/emotional_direction_signal.hpp"
+#include "signals/semantic_bias_signal.hpp"
+#include "signals/knn_bias_signal.hpp"
+#include <array>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * StaticBiasAggregator: BiasAggregator with the signal set fixed at compile time.
+ *
+ * Signals are held by value in a std::tuple and called through their
+ * concrete (final) types, so compute() is a direct, inlinable call. Weights
+ * are resolved to a fixed array once at construction instead of hashing
+ * name() per article. Scoring, confidence, labels and refusal are the same
+ * as BiasAggregator (see bias_scoring.hpp); use BiasAggregator when signals
+ * are registered at runtime.
+ *
+ * Like BiasAggregator, analyze() is const and safe to call from many threads.
+ *
+ * Example:
+ *   StaticBiasAggregator<OutletBaselineSignal, PolicyFramingSignal> aggregator;
+ *   BiasResult result = aggregator.analyze(article);
+ */
+template <typename... Signals>
+class StaticBiasAggregator {
+public:
+    static constexpr size_t kSignalCount = sizeof...(Signals);
+    static_assert(kSignalCount > 0, "StaticBiasAggregator needs at least one signal");
+
+    /**
+     * Default weights (by signal name), normalized over this signal set.
+     */
+    StaticBiasAggregator() {
+        resolve_default_weights(std::index_sequence_for<Signals...>{});
+        normalize_weights();
+    }
+
+    /**
+     * Explicit weights, one per signal in template order (normalized here).
+     */
+    explicit StaticBiasAggregator(const std::array<double, kSignalCount>& signal_weights)
+        : weights(signal_weights) {
+        normalize_weights();
+    }
+
+    /**
+     * Analyze an article (see BiasAggregator::analyze).
+     */
+    BiasResult analyze(const ArticleInput& article,
+                       const AnalysisOptions& options = {}) const {
+        static thread_local NLPContext scratch;
+        return analyze(article, scratch, options);
+    }
+
+    /**
+     * Same, with a caller-owned scratch context (reset on entry).
+     */
+    BiasResult analyze(const ArticleInput& article, NLPContext& scratch,
+                       const AnalysisOptions& options = {}) const {
+        // Step 1: Refusal pre-screen on the raw article (briefs and stubs
+        // are rejected here without being preprocessed)
+        if (insufficient_data(preprocessor, article)) {
+            return insufficient_data_result(options);
+        }
+
+        // Step 2: Preprocess; the full check agrees with the pre-screen
+        preprocessor.process(article, scratch);
+        const NLPContext& ctx = scratch;
+        if (insufficient_data(ctx)) {
+            return insufficient_data_result(options);
+        }
+
+        // Step 3: Compute all signals
+        std::array<SignalOutput, kSignalCount> outputs;
+        compute_all(ctx, article, outputs, std::index_sequence_for<Signals...>{});
+
+        // Step 4: Weighted aggregate over the signals that did not abstain
+        double weighted_sum = 0.0;
+        double active_weight = 0.0;
+        for (size_t i = 0; i < kSignalCount; ++i) {
+            const double w = outputs[i].abstained ? 0.0 : weights[i];
+            weighted_sum += outputs[i].score * w;
+            active_weight += w;
+        }
+        double aggregate_score = (active_weight > 0) ? weighted_sum / active_weight : 0.0;
+
+        // Clamp to [-1, 1]
+        aggregate_score = std::max(-1.0, std::min(1.0, aggregate_score));
+
+        // Steps 5-6: Confidence and label
+        BiasResult result{
+            .score = aggregate_score,
+            .label = bucket_label(aggregate_score),
+            .confidence = compute_confidence(ctx.token_count(), ctx.entity_count(),
+                                             outputs.data(), kSignalCount),
+            .signals = std::vector<SignalOutput>(outputs.begin(), outputs.end())
+        };
+        if (options.render_explanations) {
+            result.explanations = explain(result);
+        }
+        return result;
+    }
+
+    /**
+     * Render explanations for a result produced by this aggregator.
+     */
+    std::vector<std::string> explain(const BiasResult& result) const {
+        std::vector<std::string> explanations;
+        if (result.signals.size() != kSignalCount) {
+            explanations.push_back(kInsufficientDataExplanation);
+            return explanations;
+        }
+        explanations.reserve(kSignalCount);
+        explain_all(result, explanations, std::index_sequence_for<Signals...>{});
+        return explanations;
+    }
+
+    /**
+     * Normalized weight of the I-th signal.
+     */
+    double weight(size_t index) const { return weights[index]; }
+
+    /**
+     * Access a signal by type, e.g. to load outlet data before sharing.
+     */
+    template <typename Signal>
+    Signal& signal() { return std::get<Signal>(signals); }
+
+    template <typename Signal>
+    const Signal& signal() const { return std::get<Signal>(signals); }
+
+private:
+    Preprocessor preprocessor;
+    std::tuple<Signals...> signals;
+    std::array<double, kSignalCount> weights{};
+
+    template <size_t... I>
+    void resolve_default_weights(std::index_sequence<I...>) {
+        ((weights[I] = default_signal_weight(std::get<I>(signals).name())), ...);
+    }
+
+    void normalize_weights() {
+        double sum = 0.0;
+        for (double w : weights) {
+            sum += w;
+        }
+        if (sum > 0) {
+            for (double& w : weights) {
+                w /= sum;
+            }
+        }
+    }
+
+    template <size_t... I>
+    void compute_all(const NLPContext& ctx, const ArticleInput& article,
+                     std::array<SignalOutput, kSignalCount>& outputs,
+                     std::index_sequence<I...>) const {
+        ((outputs[I] = std::get<I>(signals).compute(ctx, article)), ...);
+    }
+
+    template <size_t... I>
+    void explain_all(const BiasResult& result, std::vector<std::string>& explanations,
+                     std::index_sequence<I...>) const {
+        (explanations.push_back(std::get<I>(signals).explain(result.signals[I])), ...);
+    }
+};
+
+/**
+ * The built-in signal set, in BiasAggregator's registration order. The
+ * kNN signal needs a deployed index, so it is not part of the default;
+ * append KnnBiasSignal to the list where one ships.
+ */
+using DefaultStaticBiasAggregator = StaticBiasAggregator<
+    OutletBaselineSignal,
+    EntitySentimentSignal,
+    PolicyFramingSignal,
+    EmotionalDirectionSignal,
+    SemanticBiasSignal>;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool: fixed set of worker threads for data-parallel loops.
+ *
+ * Workers are started once and sleep between jobs. parallel_for() hands out
+ * indices from a shared atomic counter, so uneven items (a 20k-token article
+ * next to a 300-token one) balance themselves without a scheduler. Each
+ * call to the loop body also gets the worker's number, which callers use to
+ * index per-worker state (preprocessor, context, signals) without locking.
+ *
+ * One parallel_for() runs at a time; it is not meant to be called from
+ * inside its own loop body.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threads Number of workers; 0 = std::thread::hardware_concurrency()
+     */
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    /**
+     * Run fn(worker, index) for every index in [0, count) and block until all
+     * calls have returned. worker is in [0, size()). If a call throws, the
+     * remaining indices are skipped and the first exception is rethrown here.
+     */
+    void parallel_for(size_t count,
+                      const std::function<void(size_t worker, size_t index)>& fn);
+
+private:
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    // Current job; written under the mutex before generation is bumped
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t job_count = 0;
+    std::atomic<size_t> next_index{0};
+    size_t active_workers = 0;
+    size_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+
+    void worker_loop(size_t worker);
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -12,18 +13,35 @@ struct ArticleInput {
     std::string domain;
 };
 
+// What a signal computed for one article: its score plus the two figures its
+// explanation is built from (left/right averages, term counts, similarities)
+struct SignalOutput {
+    double score = 0.0;                         // [-1.0, +1.0]
+    double left = 0.0;
+    double right = 0.0;
+    bool abstained = false;                     // no evidence: left out of score and confidence
+};
+
 // Result data structure
 struct BiasResult {
-    double score;                              // [-1.0, +1.0]
-    std::string label;                          // "Moderate Left", "Neutral", etc.
-    double confidence;                          // [0.0, 1.0]
-    std::vector<std::string> explanations;
+    double score = 0.0;                         // [-1.0, +1.0]
+    std::string label{};                        // "Moderate Left", "Neutral", etc.
+    double confidence = 0.0;                    // [0.0, 1.0]
+    std::vector<std::string> explanations{};    // empty unless rendered
+    std::vector<SignalOutput> signals{};        // per signal, aggregator order; empty if refused
+};
+
+// Per-call analysis options
+struct AnalysisOptions {
+    // Format explanation strings during analysis. Bulk scoring turns this off
+    // and renders the few it needs later with BiasAggregator::explain().
+    bool render_explanations = true;
 };
 
-// Entity mention
-struct EntityMention {
-    std::string name;
-    std::string ideology;  // "left", "right", "neutral", "unknown"
-    double sentiment;      // [-1.0, +1.0]
-    double emotion;        // [0.0, 1.0] - intensity
+// Political alignment of an entity (stored as one byte per entity)
+enum class Ideology : uint8_t {
+    Unknown = 0,
+    Left = 1,
+    Right = 2,
+    Neutral = 3,
 };
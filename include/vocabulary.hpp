@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Perfect-hash placement of a key set, as stored in a compiled image
+ * (see Vocabulary::layout()).
+ */
+struct VocabularyLayout {
+    uint32_t slot_count = 0;
+    uint32_t bucket_count = 0;
+    std::vector<uint32_t> displacements;  // bucket_count entries
+    std::vector<uint32_t> slot_key;       // slot -> key index + 1 (0 = empty)
+};
+
+/**
+ * Vocabulary: interned words with dense uint32_t ids, as a read-only view
+ * over a compiled lexicon image (see LexiconBuilder).
+ *
+ * Lookup uses a perfect hash (hash-and-displace): the word's hash picks a
+ * bucket, the bucket's displacement picks the slot, and id = slot + 1. One
+ * hash, two multiplies and one compare, no probing. Id 0 is reserved for
+ * "unknown word", so an id can always index a dense per-word table whose
+ * slot 0 holds the "no features" value.
+ *
+ * Holds no memory of its own; safe to share between threads.
+ */
+class Vocabulary {
+public:
+    static constexpr uint32_t kUnknown = 0;
+
+    // Empty vocabulary: every word is unknown
+    Vocabulary() = default;
+
+    /**
+     * @param offsets slot_count + 2 entries; word id spans [offsets[id], offsets[id+1])
+     * @param blob Concatenated words
+     * @param displacements bucket_count perfect-hash displacements
+     */
+    Vocabulary(const uint32_t* offsets, const char* blob,
+               const uint32_t* displacements,
+               uint32_t slot_count, uint32_t bucket_count)
+        : offsets(offsets), blob(blob), displacements(displacements),
+          slot_count(slot_count), bucket_count(bucket_count) {}
+
+    /**
+     * Id of a word, or kUnknown.
+     */
+    uint32_t find(std::string_view word) const;
+
+    /**
+     * Same, given hash_bytes(word) (for callers that look the word up in
+     * several vocabularies, or already hashed it).
+     */
+    uint32_t find(std::string_view word, uint64_t hash) const;
+
+    std::string_view word(uint32_t id) const {
+        if (offsets == nullptr) {
+            return {};
+        }
+        return std::string_view(blob + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // Number of ids including the reserved kUnknown (and any empty slots)
+    size_t size() const { return static_cast<size_t>(slot_count) + 1; }
+
+    // Perfect-hash placement, shared with the builders
+    static uint32_t bucket_of(uint64_t hash, uint32_t bucket_count);
+    static uint32_t slot_of(uint64_t hash, uint32_t displacement, uint32_t slot_count);
+
+    /**
+     * Place distinct keys, given by hash_bytes() of each, into a perfect
+     * hash table; key i gets id slot + 1 where slot_key[slot] == i + 1.
+     */
+    static VocabularyLayout layout(const std::vector<uint64_t>& hashes);
+
+private:
+    const uint32_t* offsets = nullptr;
+    const char* blob = nullptr;
+    const uint32_t* displacements = nullptr;
+    uint32_t slot_count = 0;
+    uint32_t bucket_count = 0;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "half_float.hpp"
+#include "vocabulary.hpp"
+#include "mapped_file.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class NLPContext;
+
+/**
+ * Storage type of the vector matrix in an embedding image.
+ */
+enum class EmbeddingPrecision : uint32_t {
+    Float32 = 0,
+    Float16 = 1,   // IEEE binary16, half the size; widened on read
+};
+
+/**
+ * On-disk layout of compiled word embeddings (little-endian, sections
+ * 8-byte aligned, the vector matrix 64-byte aligned). Written by
+ * EmbeddingBuilder::compile(), read in place by WordEmbeddings.
+ */
+struct EmbeddingImageHeader {
+    char magic[8];                // kEmbeddingImageMagic
+    uint32_t version;             // kEmbeddingImageVersion
+    uint32_t dimension;
+    uint32_t slot_count;          // perfect-hash slots; word ids are 1..slot_count
+    uint32_t bucket_count;        // perfect-hash buckets
+    uint32_t word_count;
+    uint32_t precision;           // EmbeddingPrecision
+    uint32_t reference_count;
+    uint32_t reserved;
+    uint64_t fingerprint;         // hash_bytes() of every section: identifies the model
+    // Section byte offsets from the start of the image
+    uint64_t word_offsets;        // uint32_t[slot_count + 2]
+    uint64_t word_blob;           // char[]
+    uint64_t displacements;       // uint32_t[bucket_count]
+    uint64_t weights;             // float[slot_count + 1], slot 0 = 0
+    uint64_t vectors;             // [slot_count + 1][dimension] of precision, row 0 = 0
+    uint64_t reference_offsets;   // uint32_t[reference_count + 1]
+    uint64_t reference_blob;      // char[] reference names
+    uint64_t references;          // float[reference_count][dimension], unit length
+    uint64_t total_size;
+};
+
+constexpr char kEmbeddingImageMagic[8] = {'B', 'D', 'E', 'M', 'B', 'E', 'D', 'S'};
+constexpr uint32_t kEmbeddingImageVersion = 2;
+
+/**
+ * WordEmbeddings: pretrained static word vectors (GloVe, fastText, word2vec)
+ * for SemanticBiasSignal.
+ *
+ * Vectors are converted once, offline, into an image (see EmbeddingBuilder
+ * and tools/embedding_compiler) holding a perfect-hashed Vocabulary of its
+ * own, one dense row per word id, a per-word averaging weight and named
+ * reference directions ("left", "right") built from seed words. The image
+ * is mmapped, so a 300-d, million-word table loads in the time it takes to
+ * check its offsets, and every process shares the same pages.
+ *
+ * Like Lexicon, current() loads kDefaultImagePath once per process and
+ * reload() swaps in a new version without pausing analysis. When no image
+ * is deployed, current() is empty and SemanticBiasSignal falls back to the
+ * lexicon's semantic dimensions.
+ */
+class WordEmbeddings {
+public:
+    static constexpr const char* kDefaultImagePath = "config/embeddings.bin";
+
+    // Empty table: dimension 0, every word unknown
+    WordEmbeddings();
+
+    WordEmbeddings(const WordEmbeddings&) = delete;
+    WordEmbeddings& operator=(const WordEmbeddings&) = delete;
+
+    /**
+     * Process-wide embeddings, loaded on first use from kDefaultImagePath
+     * (empty if none is deployed). Lock-free after the calling thread's
+     * first use of each version.
+     * @param version Receives the version number of the snapshot
+     */
+    static std::shared_ptr<const WordEmbeddings> current();
+    static std::shared_ptr<const WordEmbeddings> current(uint64_t& version);
+
+    // Version number of the current process-wide embeddings (+1 per publish)
+    static uint64_t version();
+
+    static void publish(std::shared_ptr<const WordEmbeddings> embeddings);
+
+    /**
+     * Load kDefaultImagePath again and publish it.
+     * @return false if it could not be loaded (the current version is kept)
+     */
+    static bool reload();
+
+    /**
+     * Map a compiled image from disk.
+     * @return false if missing or invalid (the current table is kept)
+     */
+    bool load(const std::string& image_path);
+
+    /**
+     * Adopt an image compiled in memory (EmbeddingBuilder::compile()).
+     * @return false if invalid (the current table is kept)
+     */
+    bool load_image(std::vector<uint8_t> image);
+
+    bool empty() const { return word_total == 0; }
+    size_t dimension() const { return dim; }
+    size_t size() const { return word_total; }
+    EmbeddingPrecision precision() const { return storage; }
+
+    /**
+     * Content hash of the image (words, weights, vectors, references), set
+     * by EmbeddingBuilder. Indexes built from these vectors record it, so a
+     * different model of the same dimension is detected.
+     */
+    uint64_t fingerprint() const { return model_fingerprint; }
+
+    const Vocabulary& vocabulary() const { return vocab; }
+
+    /**
+     * Averaging weight of a word id (smooth inverse frequency, so very
+     * common words count little); Vocabulary::kUnknown yields 0.
+     */
+    float weight(uint32_t id) const { return weights[id]; }
+
+    /**
+     * out[0..dimension()) += scale * vector of id.
+     */
+    void accumulate(uint32_t id, float scale, float* out) const;
+
+    /**
+     * Vector of id widened to float32 into out[0..dimension()).
+     */
+    void copy(uint32_t id, float* out) const;
+
+    /**
+     * Embedding of an analyzed text into out[0..dimension()): the sum of its
+     * token vectors, each scaled by weight(). Not normalized (all zero if no
+     * token is known); the direction is the weighted average's.
+     */
+    void embed(const NLPContext& ctx, float* out) const;
+
+    /**
+     * Unit-length reference direction by name, or nullptr.
+     */
+    const float* reference(std::string_view name) const;
+
+    // Row of a reference in similarities() output, or -1
+    int reference_index(std::string_view name) const;
+
+    /**
+     * Cosine similarity of batch vectors (row-major, batch x dimension())
+     * against every reference direction in one SimilarityKernel call;
+     * out[b * reference_count() + r].
+     */
+    void similarities(const float* rows, size_t batch, float* out) const;
+
+    size_t reference_count() const { return reference_total; }
+    std::string_view reference_name(uint32_t index) const;
+
+private:
+    MappedFile file;                // backing storage when loaded from disk
+    std::vector<uint8_t> owned;     // backing storage when compiled in memory
+
+    Vocabulary vocab;
+    const float* weights = nullptr;
+    const uint8_t* vectors = nullptr;
+    const uint32_t* reference_offsets = nullptr;
+    const char* reference_blob = nullptr;
+    const float* references = nullptr;
+    uint32_t dim = 0;
+    uint32_t word_total = 0;
+    uint32_t reference_total = 0;
+    uint64_t model_fingerprint = 0;
+    EmbeddingPrecision storage = EmbeddingPrecision::Float32;
+
+    static bool validate(const uint8_t* data, size_t size);
+    void attach(const uint8_t* data);
+};
@@ -0,0 +1,281 @@
+#include "../include/article_line_parser.hpp"
+#include <cstring>
+
+namespace {
+
+// Append a code point as UTF-8
+void append_utf8(std::string& out, unsigned code) {
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+bool ArticleLineParser::parse(std::string_view line, ArticleInput& article) {
+    pos = line.data();
+    end = line.data() + line.size();
+    id_text = std::string_view();
+    last_error.clear();
+    article.title.clear();
+    article.body.clear();
+    article.url.clear();
+    article.domain.clear();
+
+    skip_whitespace();
+    if (!expect('{')) {
+        return false;
+    }
+    skip_whitespace();
+    if (pos < end && *pos == '}') {
+        ++pos;
+    } else {
+        for (;;) {
+            skip_whitespace();
+            if (pos >= end || *pos != '"') {
+                return fail("expected a key");
+            }
+            if (!read_string(&key)) {
+                return false;
+            }
+            skip_whitespace();
+            if (!expect(':')) {
+                return false;
+            }
+            skip_whitespace();
+
+            std::string* field = (key == "title") ? &article.title
+                               : (key == "body") ? &article.body
+                               : (key == "url") ? &article.url
+                               : (key == "domain") ? &article.domain
+                               : nullptr;
+            if (field != nullptr && pos < end && *pos == '"') {
+                if (!read_string(field)) {
+                    return false;
+                }
+            } else if (field != nullptr && end - pos >= 4 && std::memcmp(pos, "null", 4) == 0) {
+                field->clear();
+                pos += 4;
+            } else if (field != nullptr) {
+                return fail("article fields must be strings");
+            } else {
+                const char* start = pos;
+                if (!skip_value(1)) {
+                    return false;
+                }
+                if (key == "id") {
+                    id_text = std::string_view(start, static_cast<size_t>(pos - start));
+                }
+            }
+
+            skip_whitespace();
+            if (pos < end && *pos == ',') {
+                ++pos;
+                continue;
+            }
+            if (!expect('}')) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    skip_whitespace();
+    if (pos != end) {
+        return fail("unexpected text after the object");
+    }
+    return true;
+}
+
+bool ArticleLineParser::fail(const char* message) {
+    last_error = message;
+    return false;
+}
+
+void ArticleLineParser::skip_whitespace() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) {
+        ++pos;
+    }
+}
+
+bool ArticleLineParser::expect(char c) {
+    if (pos >= end || *pos != c) {
+        last_error = std::string("expected '") + c + "'";
+        return false;
+    }
+    ++pos;
+    return true;
+}
+
+bool ArticleLineParser::read_string(std::string* out) {
+    ++pos;  // opening quote
+    if (out != nullptr) {
+        out->clear();
+    }
+
+    // The closing quote is searched once and again only when the one found
+    // turns out to be escaped, so the scan stays linear in the string length
+    const char* quote = static_cast<const char*>(std::memchr(pos, '"', static_cast<size_t>(end - pos)));
+    for (;;) {
+        if (quote == nullptr) {
+            return fail("unterminated string");
+        }
+        const char* backslash =
+            static_cast<const char*>(std::memchr(pos, '\\', static_cast<size_t>(quote - pos)));
+        if (backslash == nullptr) {
+            if (out != nullptr) {
+                out->append(pos, quote);
+            }
+            pos = quote + 1;
+            return true;
+        }
+
+        if (out != nullptr) {
+            out->append(pos, backslash);
+        }
+        pos = backslash + 1;
+        if (pos >= end) {
+            return fail("unterminated string");
+        }
+        char decoded;
+        switch (*pos++) {
+            case '"': decoded = '"'; break;
+            case '\\': decoded = '\\'; break;
+            case '/': decoded = '/'; break;
+            case 'b': decoded = '\b'; break;
+            case 'f': decoded = '\f'; break;
+            case 'n': decoded = '\n'; break;
+            case 'r': decoded = '\r'; break;
+            case 't': decoded = '\t'; break;
+            case 'u': {
+                unsigned code;
+                if (!read_hex4(code)) {
+                    return false;
+                }
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // High surrogate: a low surrogate escape must follow
+                    unsigned low;
+                    if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+                        return fail("unpaired surrogate in \\u escape");
+                    }
+                    pos += 2;
+                    if (!read_hex4(low)) {
+                        return false;
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return fail("unpaired surrogate in \\u escape");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return fail("unpaired surrogate in \\u escape");
+                }
+                if (out != nullptr) {
+                    append_utf8(*out, code);
+                }
+                decoded = 0;
+                break;
+            }
+            default:
+                return fail("invalid escape in string");
+        }
+        if (decoded != 0 && out != nullptr) {
+            out->push_back(decoded);
+        }
+        if (pos > quote) {
+            // That quote was escaped (or inside a \u sequence): find the next
+            quote = static_cast<const char*>(std::memchr(pos, '"', static_cast<size_t>(end - pos)));
+        }
+    }
+}
+
+bool ArticleLineParser::read_hex4(unsigned& code) {
+    if (end - pos < 4) {
+        return fail("expected 4 hex digits in \\u escape");
+    }
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+        int digit = hex_value(pos[i]);
+        if (digit < 0) {
+            return fail("expected 4 hex digits in \\u escape");
+        }
+        code = (code << 4) | static_cast<unsigned>(digit);
+    }
+    pos += 4;
+    return true;
+}
+
+bool ArticleLineParser::skip_value(size_t depth) {
+    if (pos >= end) {
+        return fail("expected a value");
+    }
+    const char c = *pos;
+    if (c == '"') {
+        return read_string(nullptr);
+    }
+    if (c == '{' || c == '[') {
+        if (depth >= kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        const char close = (c == '{') ? '}' : ']';
+        ++pos;
+        skip_whitespace();
+        if (pos < end && *pos == close) {
+            ++pos;
+            return true;
+        }
+        for (;;) {
+            skip_whitespace();
+            if (c == '{') {
+                if (pos >= end || *pos != '"') {
+                    return fail("expected a key");
+                }
+                if (!read_string(nullptr)) {
+                    return false;
+                }
+                skip_whitespace();
+                if (!expect(':')) {
+                    return false;
+                }
+                skip_whitespace();
+            }
+            if (!skip_value(depth + 1)) {
+                return false;
+            }
+            skip_whitespace();
+            if (pos < end && *pos == ',') {
+                ++pos;
+                continue;
+            }
+            return expect(close);
+        }
+    }
+
+    // Number or literal: scanned to the next delimiter, not validated
+    if (c != '-' && c != 't' && c != 'f' && c != 'n' && (c < '0' || c > '9')) {
+        return fail("expected a value");
+    }
+    while (pos < end && *pos != ',' && *pos != '}' && *pos != ']' &&
+           *pos != ' ' && *pos != '\t' && *pos != '\r') {
+        ++pos;
+    }
+    return true;
+}
@@ -1,12 +1,93 @@
 #include "../include/bias_aggregator.hpp"
+#include "../include/bias_scoring.hpp"
+#include "../include/lexicon.hpp"
+#include "../include/word_embeddings.hpp"
+#include "../include/knn_index.hpp"
+#include "../include/hash.hpp"
 #include "../include/signals/outlet_baseline_signal.hpp"
 #include "../include/signals/entity_sentiment_signal.hpp"
 #include "../include/signals/policy_framing_signal.hpp"
 #include "../include/signals/emotional_direction_signal.hpp"
 #include "../include/signals/semantic_bias_signal.hpp"
-#include <numeric>
+#include "../include/signals/knn_bias_signal.hpp"
+#include <algorithm>
 #include <sstream>
 
+namespace {
+
+// Articles a batch worker takes at a time; their embeddings are scored
+// against the reference directions in one kernel call
+constexpr size_t kBatchChunk = 16;
+
+// Versions of every process-wide table the text-only signals read (lexicon,
+// word vectors, kNN index) folded into one value; stored outputs are tagged
+// with it, so a reload of any of them retires them
+uint64_t content_generation(uint64_t lexicon_version, uint64_t embeddings_version,
+                            uint64_t index_version) {
+    const uint64_t versions[3] = {lexicon_version, embeddings_version, index_version};
+    return hash_bytes(versions, sizeof(versions));
+}
+
+// One scratch context per thread: keeps its buffers between calls
+// without making the aggregator itself mutable
+NLPContext& thread_scratch() {
+    static thread_local NLPContext scratch;
+    return scratch;
+}
+
+// Per-thread state of a batch chunk: a context per article, and the
+// gathered embeddings and their similarities
+struct ChunkScratch {
+    NLPContext contexts[kBatchChunk];
+    std::vector<float> rows;
+    std::vector<float> similarities;
+};
+
+ChunkScratch& thread_chunk_scratch() {
+    static thread_local ChunkScratch scratch;
+    return scratch;
+}
+
+/**
+ * Score every prepared context's embedding against the reference
+ * directions of its word vectors in one SimilarityKernel call, and hand
+ * each context its row. Contexts embedded with another snapshot (a reload
+ * mid-chunk) are left to SemanticBiasSignal's own single-row call.
+ */
+void score_embeddings(NLPContext* const* prepared, size_t count, ChunkScratch& scratch) {
+    const WordEmbeddings* embeddings = nullptr;
+    for (size_t i = 0; i < count && embeddings == nullptr; ++i) {
+        if (!prepared[i]->embedding.empty()) {
+            embeddings = prepared[i]->embeddings.get();
+        }
+    }
+    if (embeddings == nullptr || embeddings->reference_count() == 0) {
+        return;
+    }
+
+    const size_t dim = embeddings->dimension();
+    const size_t references = embeddings->reference_count();
+    NLPContext* members[kBatchChunk];
+    size_t batch = 0;
+    scratch.rows.resize(count * dim);
+    for (size_t i = 0; i < count; ++i) {
+        NLPContext& ctx = *prepared[i];
+        if (ctx.embeddings.get() == embeddings && !ctx.embedding.empty()) {
+            std::copy(ctx.embedding.begin(), ctx.embedding.end(), scratch.rows.begin() + batch * dim);
+            members[batch++] = &ctx;
+        }
+    }
+
+    scratch.similarities.resize(batch * references);
+    embeddings->similarities(scratch.rows.data(), batch, scratch.similarities.data());
+    for (size_t b = 0; b < batch; ++b) {
+        const float* row = scratch.similarities.data() + b * references;
+        members[b]->reference_similarity.assign(row, row + references);
+    }
+}
+
+}  // namespace
+
 BiasAggregator::BiasAggregator() {
     // Register all signals
     signals.push_back(std::make_unique<OutletBaselineSignal>());
@@ -14,54 +95,243 @@ BiasAggregator::BiasAggregator() {
     signals.push_back(std::make_unique<PolicyFramingSignal>());
     signals.push_back(std::make_unique<EmotionalDirectionSignal>());
     signals.push_back(std::make_unique<SemanticBiasSignal>());
+    // Only with a deployed index; without one it could only ever abstain
+    if (!KnnIndex::current()->empty()) {
+        signals.push_back(std::make_unique<KnnBiasSignal>());
+    }
 
     // Set default weights
-    weights = {
-        {"OutletBaseline", 0.15},
-        {"EntitySentiment", 0.30},
-        {"PolicyFraming", 0.20},
-        {"EmotionalDirection", 0.15},
-        {"SemanticBias", 0.20}  // New semantic layer
-    };
+    for (size_t i = 0; i < signals.size(); ++i) {
+        weights[signals[i]->name()] = default_signal_weight(signals[i]->name());
+        if (signals[i]->uses_metadata()) {
+            metadata_signals.push_back(i);
+        }
+    }
 
     // Normalize weights
     normalize_weights();
 }
 
-BiasResult BiasAggregator::analyze(const ArticleInput& article) {
-    // Step 1: Preprocess
-    NLPContext ctx = preprocessor.process(article);
+BiasResult BiasAggregator::analyze(const ArticleInput& article,
+                                   const AnalysisOptions& options) const {
+    return analyze(article, thread_scratch(), options);
+}
+
+std::vector<BiasResult> BiasAggregator::analyze_batch(const std::vector<ArticleInput>& articles,
+                                                      const AnalysisOptions& options) {
+    std::vector<BiasResult> results(articles.size());
+    run_batch(articles, options, [&](size_t i, BiasResult&& result) {
+        results[i] = std::move(result);
+    });
+    return results;
+}
+
+void BiasAggregator::analyze_batch(const std::vector<ArticleInput>& articles,
+                                   const BatchCallback& on_result,
+                                   const AnalysisOptions& options) {
+    run_batch(articles, options, [&](size_t i, BiasResult&& result) {
+        std::lock_guard<std::mutex> lock(callback_mutex);
+        on_result(i, std::move(result));
+    });
+}
+
+void BiasAggregator::run_batch(const std::vector<ArticleInput>& articles,
+                               const AnalysisOptions& options, const BatchCallback& deliver) {
+    if (articles.empty()) {
+        return;
+    }
+    if (!pool) {
+        pool = std::make_unique<ThreadPool>(thread_count);
+    }
+
+    // Each worker settles a chunk of articles (cache, refusal, near-duplicate,
+    // preprocessing), scores the remaining ones' embeddings together, then
+    // computes their signals; results match analyze() article for article
+    const size_t chunks = (articles.size() + kBatchChunk - 1) / kBatchChunk;
+    pool->parallel_for(chunks, [&](size_t, size_t chunk) {
+        ChunkScratch& scratch = thread_chunk_scratch();
+        const size_t first = chunk * kBatchChunk;
+        const size_t last = std::min(articles.size(), first + kBatchChunk);
+
+        NLPContext* prepared[kBatchChunk];
+        PendingEntry pending[kBatchChunk];
+        size_t index[kBatchChunk];
+        size_t count = 0;
+        for (size_t i = first; i < last; ++i) {
+            NLPContext& ctx = scratch.contexts[count];
+            BiasResult result;
+            if (settle(articles[i], ctx, options, pending[count], result)) {
+                deliver(i, std::move(result));
+            } else {
+                prepared[count] = &ctx;
+                index[count++] = i;
+            }
+        }
+
+        score_embeddings(prepared, count, scratch);
+        for (size_t k = 0; k < count; ++k) {
+            deliver(index[k], finish(articles[index[k]], *prepared[k], pending[k], options));
+        }
+    });
+}
+
+void BiasAggregator::set_cache_capacity(size_t entries) {
+    if (entries == 0) {
+        cache.reset();
+    } else {
+        cache = std::make_unique<ResultCache>(entries);
+    }
+}
+
+ResultCache::Stats BiasAggregator::cache_stats() const {
+    return cache ? cache->stats() : ResultCache::Stats{};
+}
+
+void BiasAggregator::set_near_duplicate_reuse(size_t entries, unsigned max_distance) {
+    if (entries == 0) {
+        near_duplicates.reset();
+    } else {
+        near_duplicates = std::make_unique<NearDuplicateIndex>(entries, max_distance);
+    }
+}
+
+NearDuplicateIndex::Stats BiasAggregator::near_duplicate_stats() const {
+    return near_duplicates ? near_duplicates->stats() : NearDuplicateIndex::Stats{};
+}
+
+void BiasAggregator::set_thread_count(size_t threads) {
+    if (threads == thread_count && pool) {
+        return;
+    }
+    thread_count = threads;
+    pool.reset();
+}
+
+BiasResult BiasAggregator::analyze(const ArticleInput& article, NLPContext& scratch,
+                                   const AnalysisOptions& options) const {
+    PendingEntry pending;
+    BiasResult result;
+    if (settle(article, scratch, options, pending, result)) {
+        return result;
+    }
+    return finish(article, scratch, pending, options);
+}
+
+bool BiasAggregator::settle(const ArticleInput& article, NLPContext& scratch,
+                            const AnalysisOptions& options, PendingEntry& pending,
+                            BiasResult& result) const {
+    // Step 0: Result cache. Text-only outputs are reused; metadata signals
+    // are recomputed for this article's domain. Entries are per content
+    // generation, so a reload of the lexicon, word vectors or kNN index
+    // never serves results computed with the previous version.
+    pending.index_version = KnnIndex::version();
+    pending.generation = content_generation(Lexicon::version(), WordEmbeddings::version(),
+                                            pending.index_version);
+    if (cache) {
+        pending.cache_key = ResultCache::key_for(article, pending.generation);
+        ResultCache::Entry cached;
+        if (cache->lookup(pending.cache_key, cached)) {
+            result = cached.refused ? insufficient_data_result(options)
+                                    : reuse(cached, article, scratch, options);
+            return true;
+        }
+    }
+
+    // Step 1: Refusal pre-screen on the raw article (briefs and stubs
+    // are rejected here without being preprocessed)
+    if (insufficient_data(preprocessor, article)) {
+        if (cache) {
+            cache->insert(pending.cache_key, ResultCache::Entry{.refused = true});
+        }
+        result = insufficient_data_result(options);
+        return true;
+    }
+
+    // Step 1b: Near-duplicate of a recently analyzed article (refusals are
+    // decided exactly above, so only analyzed articles are indexed)
+    if (near_duplicates) {
+        pending.fingerprint = NearDuplicateIndex::fingerprint(article);
+        ResultCache::Entry similar;
+        if (near_duplicates->find(pending.fingerprint, pending.generation, similar)) {
+            result = reuse(similar, article, scratch, options);
+            return true;
+        }
+    }
+
+    // Step 2: Preprocess; the full check agrees with the pre-screen
+    preprocessor.process(article, scratch);
+    if (insufficient_data(scratch)) {
+        if (cache) {
+            cache->insert(pending.cache_key, ResultCache::Entry{.refused = true});
+        }
+        result = insufficient_data_result(options);
+        return true;
+    }
+    return false;
+}
+
+BiasResult BiasAggregator::finish(const ArticleInput& article, const NLPContext& ctx,
+                                  const PendingEntry& pending,
+                                  const AnalysisOptions& options) const {
+    // Step 3: Compute all signals (explanations are rendered from these
+    // outputs, now or later via explain())
+    std::vector<SignalOutput> outputs;
+    outputs.reserve(signals.size());
+    for (const auto& signal : signals) {
+        outputs.push_back(signal->compute(ctx, article));
+    }
 
-    // Step 2: Refusal logic
-    if (insufficient_data(ctx)) {
-        return BiasResult{
-            .score = 0.0,
-            .label = "Insufficient Data",
-            .confidence = 0.0,
-            .explanations = {"Article is too short or has too few entities for reliable analysis"}
+    if (cache || near_duplicates) {
+        // The tables the signals actually read: the preprocessor pinned the
+        // lexicon and word vectors; the kNN index version was taken before
+        // the signal acquired it, so a reload in between only retires the
+        // entry early
+        const uint64_t generation = content_generation(ctx.lexicon_version, ctx.embeddings_version,
+                                                       pending.index_version);
+        ResultCache::Entry entry{
+            .refused = false,
+            .token_count = static_cast<uint32_t>(ctx.token_count()),
+            .entity_count = static_cast<uint32_t>(ctx.entity_count()),
+            .outputs = outputs,
+            .generation = generation
         };
+        if (near_duplicates) {
+            near_duplicates->insert(pending.fingerprint, entry);
+        }
+        if (cache) {
+            // A reload between step 0 and preprocessing changed the generation
+            ResultCache::Key cache_key = pending.cache_key;
+            if (generation != pending.generation) {
+                cache_key = ResultCache::key_for(article, generation);
+            }
+            cache->insert(cache_key, std::move(entry));
+        }
     }
 
-    // Step 3: Compute all signals
-    std::vector<double> signal_scores;
-    std::vector<std::string> explanations;
+    return score(std::move(outputs), ctx.token_count(), ctx.entity_count(), options);
+}
 
-    for (auto& signal : signals) {
-        double score = signal->compute(ctx, article);
-        signal_scores.push_back(score);
-        explanations.push_back(signal->explain());
+BiasResult BiasAggregator::reuse(ResultCache::Entry& entry, const ArticleInput& article,
+                                 NLPContext& scratch, const AnalysisOptions& options) const {
+    scratch.reset();
+    for (size_t i : metadata_signals) {
+        entry.outputs[i] = signals[i]->compute(scratch, article);
     }
+    return score(std::move(entry.outputs), entry.token_count, entry.entity_count, options);
+}
 
-    // Step 4: Weighted aggregate
+BiasResult BiasAggregator::score(std::vector<SignalOutput> outputs, size_t token_count,
+                                 size_t entity_count, const AnalysisOptions& options) const {
+    // Step 4: Weighted aggregate over the signals that did not abstain
     double weighted_sum = 0.0;
     double weight_sum = 0.0;
 
     size_t i = 0;
-    for (auto& signal : signals) {
+    for (const auto& signal : signals) {
         auto it = weights.find(signal->name());
-        double weight = (it != weights.end()) ? it->second : 0.0;
+        double weight = (it != weights.end() && !outputs[i].abstained) ? it->second : 0.0;
         
-        weighted_sum += signal_scores[i] * weight;
+        weighted_sum += outputs[i].score * weight;
         weight_sum += weight;
         i++;
     }
@@ -72,76 +342,41 @@ BiasResult BiasAggregator::analyze(const ArticleInput& article) {
     aggregate_score = std::max(-1.0, std::min(1.0, aggregate_score));
 
     // Step 5: Compute confidence
-    double confidence = compute_confidence(ctx, signal_scores);
+    double confidence = compute_confidence(token_count, entity_count,
+                                           outputs.data(), outputs.size());
 
     // Step 6: Bucket label
     std::string label = bucket_label(aggregate_score);
 
-    return BiasResult{
+    BiasResult result{
         .score = aggregate_score,
         .label = label,
         .confidence = confidence,
-        .explanations = explanations
+        .signals = std::move(outputs)
     };
+    if (options.render_explanations) {
+        result.explanations = explain(result);
+    }
+    return result;
 }
 
-void BiasAggregator::set_signal_weight(const std::string& signal_name, double weight) {
-    weights[signal_name] = weight;
-    normalize_weights();
-}
-
-bool BiasAggregator::insufficient_data(const NLPContext& ctx) const {
-    // Thresholds: minimum token count and entity count
-    return ctx.token_count() < 100 || ctx.entity_count() < 1;
-}
-
-double BiasAggregator::compute_confidence(const NLPContext& ctx,
-                                          const std::vector<double>& scores) const {
-    if (scores.empty()) {
-        return 0.0;
+std::vector<std::string> BiasAggregator::explain(const BiasResult& result) const {
+    std::vector<std::string> explanations;
+    if (result.signals.empty()) {
+        explanations.push_back(kInsufficientDataExplanation);
+        return explanations;
     }
 
-    // Confidence factors:
-    // 1. Agreement between signals (lower variance = higher confidence)
-    // 2. Data quantity (more entities/tokens = higher confidence)
-    // 3. Entity diversity
-
-    // Calculate signal agreement
-    double mean_score = std::accumulate(scores.begin(), scores.end(), 0.0) / scores.size();
-    double variance = 0.0;
-    for (double score : scores) {
-        variance += (score - mean_score) * (score - mean_score);
+    explanations.reserve(signals.size());
+    for (size_t i = 0; i < signals.size() && i < result.signals.size(); ++i) {
+        explanations.push_back(signals[i]->explain(result.signals[i]));
     }
-    variance /= scores.size();
-
-    // Agreement: 1 / (1 + variance) bounded to [0, 1]
-    double agreement_confidence = 1.0 / (1.0 + variance);
-
-    // Data quantity: sigmoid on token count and entity count
-    double token_ratio = std::min(1.0, static_cast<double>(ctx.token_count()) / 1000.0);
-    double entity_ratio = std::min(1.0, static_cast<double>(ctx.entity_count()) / 10.0);
-    double data_confidence = (token_ratio + entity_ratio) / 2.0;
-
-    // Combined confidence (average)
-    return (agreement_confidence + data_confidence) / 2.0;
+    return explanations;
 }
 
-std::string BiasAggregator::bucket_label(double score) const {
-    if (score >= 0.6) {
-        return "Strong Right";
-    } else if (score >= 0.3) {
-        return "Moderate Right";
-    } else if (score >= 0.1) {
-        return "Slight Right";
-    } else if (score > -0.1) {
-        return "Neutral";
-    } else if (score >= -0.3) {
-        return "Slight Left";
-    } else if (score >= -0.6) {
-        return "Moderate Left";
-    } else {
-        return "Strong Left";
-    }
+void BiasAggregator::set_signal_weight(const std::string& signal_name, double weight) {
+    weights[signal_name] = weight;
+    normalize_weights();
 }
 
 void BiasAggregator::normalize_weights() {
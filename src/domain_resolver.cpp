@@ -0,0 +1,267 @@
+#include "../include/domain_resolver.hpp"
+#include "../include/hash.hpp"
+
+namespace {
+
+// Common public suffixes below the top level (country second-level domains
+// that carry news outlets, plus shared hosting platforms). Single-label
+// top-level domains are public by rule and need no entry.
+constexpr const char* kPublicSuffixes[] = {
+    "co.uk", "org.uk", "ac.uk", "gov.uk", "ltd.uk", "plc.uk", "me.uk", "net.uk",
+    "com.au", "net.au", "org.au", "edu.au", "gov.au", "asn.au", "id.au",
+    "co.nz", "net.nz", "org.nz", "govt.nz",
+    "co.za", "org.za", "gov.za", "net.za",
+    "co.jp", "or.jp", "ne.jp", "ac.jp", "go.jp",
+    "co.kr", "or.kr", "go.kr",
+    "co.in", "net.in", "org.in", "gov.in",
+    "co.il", "org.il", "gov.il",
+    "co.ke", "or.ke", "go.ke",
+    "com.ar", "com.br", "com.mx", "com.co", "com.pe", "com.ve",
+    "com.cn", "net.cn", "org.cn", "gov.cn",
+    "com.hk", "com.tw", "com.sg", "com.my", "com.ph", "com.pk", "com.bd",
+    "com.tr", "org.tr", "gov.tr",
+    "com.eg", "org.eg", "com.sa", "com.lb", "com.qa", "com.ng", "com.gh",
+    "com.ua", "org.ua", "com.ru", "rep.kp",
+    "blogspot.com", "wordpress.com", "github.io", "herokuapp.com", "appspot.com",
+};
+
+inline uint64_t label_seed(uint32_t parent) {
+    return (static_cast<uint64_t>(parent) + 1) * 0x9E3779B97F4A7C15ULL;
+}
+
+inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+// stored is already lowercase
+inline bool equals_folded(std::string_view text, const char* stored, size_t length) {
+    if (text.size() != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (lower(text[i]) != stored[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Byte classes for host_of(): RFC 3986 scheme characters, the bytes that
+// end an authority, and the bytes that need a closer look inside one
+enum UrlByte : uint8_t { kSchemeByte = 1, kEndByte = 2, kMarkByte = 4 };
+
+struct UrlByteTable {
+    uint8_t cls[256];
+
+    constexpr UrlByteTable() : cls() {
+        for (int c = 0; c < 256; ++c) {
+            bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            cls[c] = (alnum || c == '+' || c == '-' || c == '.') ? kSchemeByte : 0;
+        }
+        cls[static_cast<int>('/')] = kEndByte;
+        cls[static_cast<int>('?')] = kEndByte;
+        cls[static_cast<int>('#')] = kEndByte;
+        cls[static_cast<int>(':')] = kMarkByte;
+        cls[static_cast<int>('@')] = kMarkByte;
+        cls[static_cast<int>('[')] = kMarkByte;
+    }
+};
+
+constexpr UrlByteTable kUrlBytes;
+
+inline uint8_t url_class(char c) {
+    return kUrlBytes.cls[static_cast<uint8_t>(c)];
+}
+
+// Strip one trailing root dot ("cnn.com." is "cnn.com")
+inline std::string_view trim_root(std::string_view host) {
+    if (!host.empty() && host.back() == '.') {
+        host.remove_suffix(1);
+    }
+    return host;
+}
+
+}  // namespace
+
+DomainResolver::DomainResolver() : nodes(1), edges(64) {
+    for (const char* suffix : kPublicSuffixes) {
+        add_public_suffix(suffix);
+    }
+}
+
+void DomainResolver::add(std::string_view domain, uint32_t value) {
+    uint32_t node = insert(trim_root(domain));
+    if (node == 0 || value == kNoMatch) {
+        return;
+    }
+    if (nodes[node].value == kNoMatch) {
+        ++domain_total;
+    }
+    nodes[node].value = value;
+}
+
+void DomainResolver::add_public_suffix(std::string_view suffix) {
+    uint32_t node = insert(trim_root(suffix));
+    if (node != 0) {
+        nodes[node].public_suffix = true;
+    }
+}
+
+uint32_t DomainResolver::insert(std::string_view domain) {
+    uint32_t node = 0;
+    size_t end = domain.size();
+    while (end > 0) {
+        size_t dot = domain.rfind('.', end - 1);
+        size_t start = (dot == std::string_view::npos) ? 0 : dot + 1;
+        std::string_view label = domain.substr(start, end - start);
+        if (label.empty()) {
+            return 0;  // "a..b" or leading dot: not a domain
+        }
+
+        uint64_t hash = hash_bytes_folded(label, label_seed(node));
+        uint32_t next = child(node, label, hash);
+        if (next == 0) {
+            Node created;
+            created.parent = node;
+            created.label_offset = static_cast<uint32_t>(labels.size());
+            created.label_length = static_cast<uint32_t>(label.size());
+            for (char c : label) {
+                labels.push_back(lower(c));
+            }
+            next = static_cast<uint32_t>(nodes.size());
+            nodes.push_back(created);
+
+            // Keep the edge table at most half full so probes stay short
+            if (2 * (edge_total + 1) > edges.size()) {
+                std::vector<Edge> old(edges.size() * 2);
+                old.swap(edges);
+                for (const Edge& edge : old) {
+                    if (edge.child != 0) {
+                        place(edge);
+                    }
+                }
+            }
+            place(Edge{hash, node, next});
+            ++edge_total;
+        }
+
+        node = next;
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        end = dot;
+    }
+    return node;
+}
+
+void DomainResolver::place(const Edge& edge) {
+    const size_t mask = edges.size() - 1;
+    size_t i = edge.hash & mask;
+    while (edges[i].child != 0) {
+        i = (i + 1) & mask;
+    }
+    edges[i] = edge;
+}
+
+uint32_t DomainResolver::child(uint32_t parent, std::string_view label, uint64_t hash) const {
+    const size_t mask = edges.size() - 1;
+    for (size_t i = hash & mask; edges[i].child != 0; i = (i + 1) & mask) {
+        const Edge& edge = edges[i];
+        if (edge.hash != hash || edge.parent != parent) {
+            continue;
+        }
+        const Node& node = nodes[edge.child];
+        if (equals_folded(label, labels.data() + node.label_offset, node.label_length)) {
+            return edge.child;
+        }
+    }
+    return 0;
+}
+
+uint32_t DomainResolver::resolve(std::string_view host) const {
+    host = trim_root(host);
+
+    uint32_t node = 0;
+    uint32_t best = kNoMatch;
+    size_t end = host.size();
+    while (end > 0) {
+        size_t dot = host.rfind('.', end - 1);
+        size_t start = (dot == std::string_view::npos) ? 0 : dot + 1;
+        std::string_view label = host.substr(start, end - start);
+        if (label.empty()) {
+            break;
+        }
+
+        node = child(node, label, hash_bytes_folded(label, label_seed(node)));
+        if (node == 0) {
+            break;
+        }
+
+        const Node& current = nodes[node];
+        if (current.public_suffix || current.parent == 0) {
+            best = kNoMatch;  // anything at or above a public suffix is not an outlet
+        } else if (current.value != kNoMatch) {
+            best = current.value;
+        }
+
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        end = dot;
+    }
+    return best;
+}
+
+std::string_view DomainResolver::host_of(std::string_view url) {
+    const size_t n = url.size();
+
+    // Bare domains ("www.cnn.com", "cnn.com/path") are all scheme bytes up
+    // to the end or a path: the common case costs one table lookup per byte
+    size_t i = 0;
+    while (i < n && (url_class(url[i]) & kSchemeByte)) {
+        ++i;
+    }
+    if (i == n || (i > 0 && (url_class(url[i]) & kEndByte))) {
+        return trim_root(url.substr(0, i));
+    }
+
+    // Skip "scheme://" (or a scheme-relative "//"); otherwise the ':' that
+    // stopped the scan starts a port
+    size_t begin = 0;
+    if (i > 0 && i + 2 < n && url[i] == ':' && url[i + 1] == '/' && url[i + 2] == '/') {
+        begin = i + 3;
+    } else if (n >= 2 && url[0] == '/' && url[1] == '/') {
+        begin = 2;
+    }
+
+    // One pass over the authority: userinfo ends at the last '@', the port
+    // starts at the first ':' after it
+    size_t host_begin = begin;
+    size_t colon = std::string_view::npos;
+    size_t end = begin;
+    for (; end < n; ++end) {
+        uint8_t cls = url_class(url[end]);
+        if (cls & kEndByte) {
+            break;
+        }
+        if (cls & kMarkByte) {
+            if (url[end] == '@') {
+                host_begin = end + 1;
+                colon = std::string_view::npos;
+            } else if (url[end] == ':' && colon == std::string_view::npos) {
+                colon = end;
+            }
+        }
+    }
+
+    std::string_view host = url.substr(host_begin, end - host_begin);
+    if (!host.empty() && host.front() == '[') {
+        // IPv6 literal: keep the brackets, drop the port
+        size_t close = host.find(']');
+        return host.substr(0, close == std::string_view::npos ? close : close + 1);
+    }
+    if (colon != std::string_view::npos) {
+        host = url.substr(host_begin, colon - host_begin);
+    }
+    return trim_root(host);
+}
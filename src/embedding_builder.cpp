@@ -0,0 +1,400 @@
+#include "../include/embedding_builder.hpp"
+#include "../include/hash.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+std::string lowercase(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c | 0x20);
+        }
+    }
+    return out;
+}
+
+// Split on spaces and tabs, skipping empty fields (views into line)
+std::vector<std::string_view> split_blank(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t') {
+            ++i;
+        }
+        if (i > start) {
+            fields.push_back(line.substr(start, i - start));
+        }
+    }
+    return fields;
+}
+
+bool parse_float(std::string_view text, float& out) {
+    std::string value(text);
+    char* end = nullptr;
+    out = std::strtof(value.c_str(), &end);
+    return !value.empty() && end == value.c_str() + value.size();
+}
+
+bool parse_count(std::string_view text, size_t& out) {
+    if (text.empty() || text.size() > 12) {
+        return false;
+    }
+    out = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        out = out * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+bool ends_with(const std::string& text, const char* suffix) {
+    size_t n = std::char_traits<char>::length(suffix);
+    return text.size() >= n && text.compare(text.size() - n, n, suffix) == 0;
+}
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+size_t align64(size_t offset) {
+    return (offset + 63) & ~static_cast<size_t>(63);
+}
+
+}  // namespace
+
+bool EmbeddingBuilder::load_vectors(const std::string& path, size_t max_words) {
+    last_error.clear();
+    return ends_with(path, ".bin") ? load_word2vec(path, max_words) : load_text(path, max_words);
+}
+
+bool EmbeddingBuilder::load_text(const std::string& path, size_t max_words) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        last_error = path + ": cannot open";
+        return false;
+    }
+
+    std::string line;
+    std::vector<float> values;
+    size_t line_number = 0;
+    size_t loaded = 0;
+    while ((max_words == 0 || loaded < max_words) && std::getline(file, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::vector<std::string_view> fields = split_blank(line);
+        if (fields.empty()) {
+            continue;
+        }
+
+        // fastText .vec files start with "count dim"
+        size_t count;
+        size_t header_dim;
+        if (line_number == 1 && fields.size() == 2 &&
+            parse_count(fields[0], count) && parse_count(fields[1], header_dim)) {
+            if (dim != 0 && dim != header_dim) {
+                last_error = path + ":1: dimension " + std::to_string(header_dim) +
+                             " does not match " + std::to_string(dim);
+                return false;
+            }
+            dim = header_dim;
+            continue;
+        }
+
+        // Some GloVe releases have words with spaces: the last dim fields
+        // are the vector, everything before it the word
+        size_t value_count = (dim != 0) ? dim : fields.size() - 1;
+        if (value_count == 0 || fields.size() < value_count + 1) {
+            last_error = path + ":" + std::to_string(line_number) + ": expected: word v1 ... v" +
+                         std::to_string(value_count == 0 ? 1 : value_count);
+            return false;
+        }
+        size_t word_fields = fields.size() - value_count;
+        std::string_view word(fields[0].data(),
+                              static_cast<size_t>(fields[word_fields - 1].data() +
+                                                  fields[word_fields - 1].size() - fields[0].data()));
+
+        values.resize(value_count);
+        for (size_t d = 0; d < value_count; ++d) {
+            if (!parse_float(fields[word_fields + d], values[d])) {
+                last_error = path + ":" + std::to_string(line_number) + ": bad number '" +
+                             std::string(fields[word_fields + d]) + "'";
+                return false;
+            }
+        }
+        if (!add(word, values)) {
+            last_error = path + ":" + std::to_string(line_number) + ": " + last_error;
+            return false;
+        }
+        ++loaded;
+    }
+
+    if (loaded == 0) {
+        last_error = path + ": no vectors found";
+        return false;
+    }
+    return true;
+}
+
+bool EmbeddingBuilder::load_word2vec(const std::string& path, size_t max_words) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        last_error = path + ": cannot open";
+        return false;
+    }
+
+    std::string header;
+    std::getline(file, header);
+    std::vector<std::string_view> fields = split_blank(header);
+    size_t count;
+    size_t header_dim;
+    if (fields.size() != 2 || !parse_count(fields[0], count) || !parse_count(fields[1], header_dim) ||
+        header_dim == 0) {
+        last_error = path + ": expected a \"count dim\" header";
+        return false;
+    }
+    if (max_words != 0 && max_words < count) {
+        count = max_words;
+    }
+
+    std::vector<float> values(header_dim);
+    std::string word;
+    for (size_t i = 0; i < count; ++i) {
+        // Word up to a space; some writers put a newline after each vector
+        word.clear();
+        int c;
+        while ((c = file.get()) != EOF && c != ' ') {
+            if (c != '\n') {
+                word.push_back(static_cast<char>(c));
+            }
+        }
+        file.read(reinterpret_cast<char*>(values.data()),
+                  static_cast<std::streamsize>(sizeof(float) * header_dim));
+        if (!file || word.empty()) {
+            last_error = path + ": truncated at word " + std::to_string(i + 1);
+            return false;
+        }
+        if (!add(word, values)) {
+            last_error = path + ": " + last_error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EmbeddingBuilder::load_seeds(const std::string& path) {
+    last_error.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        last_error = path + ": cannot open";
+        return false;
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0 || tab + 1 == line.size()) {
+            last_error = path + ":" + std::to_string(line_number) + ": expected: word <TAB> reference";
+            return false;
+        }
+        add_seed(std::string_view(line).substr(0, tab), std::string_view(line).substr(tab + 1));
+    }
+    return true;
+}
+
+bool EmbeddingBuilder::add(std::string_view word, const std::vector<float>& values) {
+    if (values.empty() || (dim != 0 && values.size() != dim)) {
+        last_error = "vector has " + std::to_string(values.size()) + " values, expected " +
+                     std::to_string(dim);
+        return false;
+    }
+    dim = values.size();
+
+    auto [it, inserted] = index.emplace(lowercase(word), static_cast<uint32_t>(words.size()));
+    if (inserted) {
+        words.push_back(it->first);
+        matrix.insert(matrix.end(), values.begin(), values.end());
+    }
+    return true;
+}
+
+void EmbeddingBuilder::add_seed(std::string_view word, std::string_view reference) {
+    seeds.push_back(Seed{lowercase(word), std::string(reference)});
+}
+
+std::vector<uint8_t> EmbeddingBuilder::compile(EmbeddingPrecision precision) const {
+    const uint32_t n = static_cast<uint32_t>(words.size());
+    const size_t element = (precision == EmbeddingPrecision::Float16) ? 2 : 4;
+
+    std::vector<uint64_t> hashes(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        hashes[i] = hash_bytes(words[i]);
+    }
+    const VocabularyLayout layout = Vocabulary::layout(hashes);
+    const uint32_t slot_count = layout.slot_count;
+    const uint32_t bucket_count = layout.bucket_count;
+
+    // Reference directions: normalized mean of the seeds' unit vectors
+    std::vector<std::string> reference_names;
+    std::vector<std::vector<float>> reference_vectors;
+    for (const Seed& seed : seeds) {
+        auto found = index.find(seed.word);
+        if (found == index.end()) {
+            continue;
+        }
+        size_t r = 0;
+        while (r < reference_names.size() && reference_names[r] != seed.reference) {
+            ++r;
+        }
+        if (r == reference_names.size()) {
+            reference_names.push_back(seed.reference);
+            reference_vectors.emplace_back(dim, 0.0f);
+        }
+        const float* row = matrix.data() + static_cast<size_t>(found->second) * dim;
+        double norm = 0.0;
+        for (size_t d = 0; d < dim; ++d) {
+            norm += static_cast<double>(row[d]) * row[d];
+        }
+        if (norm > 0.0) {
+            const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+            for (size_t d = 0; d < dim; ++d) {
+                reference_vectors[r][d] += scale * row[d];
+            }
+        }
+    }
+    for (auto& vector : reference_vectors) {
+        double norm = 0.0;
+        for (float v : vector) {
+            norm += static_cast<double>(v) * v;
+        }
+        if (norm > 0.0) {
+            const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+            for (float& v : vector) {
+                v *= scale;
+            }
+        }
+    }
+    const uint32_t reference_count = static_cast<uint32_t>(reference_names.size());
+
+    // Section layout
+    EmbeddingImageHeader header{};
+    std::memcpy(header.magic, kEmbeddingImageMagic, sizeof(header.magic));
+    header.version = kEmbeddingImageVersion;
+    header.dimension = static_cast<uint32_t>(dim);
+    header.slot_count = slot_count;
+    header.bucket_count = bucket_count;
+    header.word_count = n;
+    header.precision = static_cast<uint32_t>(precision);
+    header.reference_count = reference_count;
+
+    size_t word_blob_size = 0;
+    for (const auto& w : words) {
+        word_blob_size += w.size();
+    }
+    size_t reference_blob_size = 0;
+    for (const auto& name : reference_names) {
+        reference_blob_size += name.size();
+    }
+
+    size_t offset = align8(sizeof(EmbeddingImageHeader));
+    header.word_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * (static_cast<size_t>(slot_count) + 2));
+    header.word_blob = offset;
+    offset = align8(offset + word_blob_size);
+    header.displacements = offset;
+    offset = align8(offset + sizeof(uint32_t) * bucket_count);
+    header.weights = offset;
+    offset = align64(offset + sizeof(float) * (static_cast<size_t>(slot_count) + 1));
+    header.vectors = offset;
+    offset = align8(offset + element * (static_cast<size_t>(slot_count) + 1) * dim);
+    header.reference_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * (static_cast<size_t>(reference_count) + 1));
+    header.reference_blob = offset;
+    offset = align8(offset + reference_blob_size);
+    header.references = offset;
+    offset = align8(offset + sizeof(float) * reference_count * dim);
+    header.total_size = offset;
+
+    std::vector<uint8_t> image(offset, 0);
+    uint8_t* base = image.data();
+    std::memcpy(base, &header, sizeof(header));
+
+    // Smooth inverse frequency weight a / (a + p(w)), with p(w) estimated
+    // from the word's frequency rank by Zipf's law
+    constexpr double kSmoothing = 1e-3;
+    const double harmonic = std::log(static_cast<double>(n) + 1.0) + 0.5772156649;
+
+    // Words, weights and vectors in id order; empty slots are zero
+    auto* word_offsets = reinterpret_cast<uint32_t*>(base + header.word_offsets);
+    char* word_blob = reinterpret_cast<char*>(base + header.word_blob);
+    auto* weights = reinterpret_cast<float*>(base + header.weights);
+    uint8_t* vectors = base + header.vectors;
+    uint32_t cursor = 0;
+    word_offsets[0] = 0;
+    for (uint32_t id = 1; id <= slot_count; ++id) {
+        word_offsets[id] = cursor;
+        uint32_t key = layout.slot_key[id - 1];
+        if (key == 0) {
+            continue;
+        }
+        const uint32_t position = key - 1;
+        const std::string& w = words[position];
+        std::memcpy(word_blob + cursor, w.data(), w.size());
+        cursor += static_cast<uint32_t>(w.size());
+
+        const double probability = 1.0 / ((position + 1.0) * harmonic);
+        weights[id] = static_cast<float>(kSmoothing / (kSmoothing + probability));
+
+        const float* row = matrix.data() + static_cast<size_t>(position) * dim;
+        uint8_t* out = vectors + element * static_cast<size_t>(id) * dim;
+        if (precision == EmbeddingPrecision::Float16) {
+            for (size_t d = 0; d < dim; ++d) {
+                uint16_t half = float_to_half(row[d]);
+                std::memcpy(out + 2 * d, &half, sizeof(half));
+            }
+        } else {
+            std::memcpy(out, row, sizeof(float) * dim);
+        }
+    }
+    word_offsets[slot_count + 1] = cursor;
+
+    if (bucket_count > 0) {
+        std::memcpy(base + header.displacements, layout.displacements.data(),
+                    sizeof(uint32_t) * bucket_count);
+    }
+
+    auto* reference_offsets = reinterpret_cast<uint32_t*>(base + header.reference_offsets);
+    char* reference_blob = reinterpret_cast<char*>(base + header.reference_blob);
+    auto* references = reinterpret_cast<float*>(base + header.references);
+    cursor = 0;
+    for (uint32_t r = 0; r < reference_count; ++r) {
+        reference_offsets[r] = cursor;
+        std::memcpy(reference_blob + cursor, reference_names[r].data(), reference_names[r].size());
+        cursor += static_cast<uint32_t>(reference_names[r].size());
+        std::memcpy(references + static_cast<size_t>(r) * dim, reference_vectors[r].data(),
+                    sizeof(float) * dim);
+    }
+    reference_offsets[reference_count] = cursor;
+
+    reinterpret_cast<EmbeddingImageHeader*>(base)->fingerprint =
+        hash_bytes(base + header.word_offsets, header.total_size - header.word_offsets);
+    return image;
+}
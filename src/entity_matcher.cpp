@@ -0,0 +1,89 @@
+#include "../include/entity_matcher.hpp"
+#include <algorithm>
+
+EntityMatcher::EntityMatcher() {
+    states.emplace_back();
+    pending_edges.emplace_back();
+    std::fill(std::begin(root_next), std::end(root_next), kRoot);
+}
+
+void EntityMatcher::add(std::string_view pattern, uint32_t id) {
+    if (pattern.empty()) {
+        return;
+    }
+
+    uint32_t state = kRoot;
+    for (char raw : pattern) {
+        uint8_t c = static_cast<uint8_t>(raw);
+        if (c >= 'A' && c <= 'Z') {
+            c |= 0x20;
+        }
+
+        auto& edges = pending_edges[state];
+        auto it = std::find_if(edges.begin(), edges.end(),
+                               [c](const auto& edge) { return edge.first == c; });
+        if (it != edges.end()) {
+            state = it->second;
+            continue;
+        }
+
+        uint32_t next = static_cast<uint32_t>(states.size());
+        states.emplace_back();
+        pending_edges.emplace_back();
+        pending_edges[state].emplace_back(c, next);
+        state = next;
+    }
+
+    if (states[state].output == kNoOutput) {
+        states[state].output = static_cast<uint32_t>(pattern_ids.size());
+        pattern_ids.push_back(id);
+        pattern_lengths.push_back(static_cast<uint32_t>(pattern.size()));
+    }
+}
+
+void EntityMatcher::build() {
+    // Flatten trie edges into sorted CSR arrays
+    edge_labels.clear();
+    edge_targets.clear();
+    for (size_t s = 0; s < states.size(); ++s) {
+        auto& edges = pending_edges[s];
+        std::sort(edges.begin(), edges.end());
+        states[s].edge_begin = static_cast<uint32_t>(edge_labels.size());
+        states[s].edge_count = static_cast<uint32_t>(edges.size());
+        for (const auto& [label, target] : edges) {
+            edge_labels.push_back(label);
+            edge_targets.push_back(target);
+        }
+    }
+
+    // Dense root row: missing edges loop back to the root
+    std::fill(std::begin(root_next), std::end(root_next), kRoot);
+    for (const auto& [label, target] : pending_edges[kRoot]) {
+        root_next[label] = target;
+    }
+
+    // Breadth-first failure links; a state's fail target is always shallower,
+    // so it is final by the time the state is dequeued
+    std::vector<uint32_t> queue;
+    queue.reserve(states.size());
+    for (const auto& [label, target] : pending_edges[kRoot]) {
+        states[target].fail = kRoot;
+        states[target].dict_link = kNoOutput;
+        queue.push_back(target);
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t state = queue[head];
+        for (const auto& [label, child] : pending_edges[state]) {
+            uint32_t fail = step(states[state].fail, label);
+            states[child].fail = fail;
+            states[child].dict_link = (states[fail].output != kNoOutput)
+                                          ? fail
+                                          : states[fail].dict_link;
+            queue.push_back(child);
+        }
+    }
+
+    pending_edges.clear();
+    pending_edges.shrink_to_fit();
+}
@@ -0,0 +1,386 @@
+#include "../include/json_reader.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+inline bool is_digit(int c) {
+    return c >= '0' && c <= '9';
+}
+
+// Append a code point as UTF-8
+void append_utf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+}  // namespace
+
+JsonReader::JsonReader(size_t max_depth) : depth_limit(max_depth) {}
+
+bool JsonReader::parse(std::istream& stream, JsonHandler& handler) {
+    in = &stream;
+    buffer.resize(kChunkSize);
+    pos = end = buffer.data();
+    return run(handler);
+}
+
+bool JsonReader::parse(std::string_view text, JsonHandler& handler) {
+    in = nullptr;
+    pos = text.data();
+    end = text.data() + text.size();
+    return run(handler);
+}
+
+bool JsonReader::parse_file(const std::string& path, JsonHandler& handler) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        last_error = path + ": cannot open";
+        fail_line = fail_column = 0;
+        return false;
+    }
+    if (!parse(file, handler)) {
+        last_error = path + ":" + last_error;
+        return false;
+    }
+    return true;
+}
+
+bool JsonReader::run(JsonHandler& handler) {
+    line = 1;
+    column = 1;
+    last_error.clear();
+    fail_line = fail_column = 0;
+
+    skip_whitespace();
+    if (!parse_value(handler, 0)) {
+        return false;
+    }
+    skip_whitespace();
+    if (peek() != -1) {
+        return fail("unexpected data after the document");
+    }
+    return true;
+}
+
+bool JsonReader::refill() {
+    if (in == nullptr || !*in) {
+        return false;
+    }
+    in->read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    pos = buffer.data();
+    end = pos + in->gcount();
+    return pos != end;
+}
+
+int JsonReader::peek() {
+    if (pos == end && !refill()) {
+        return -1;
+    }
+    return static_cast<unsigned char>(*pos);
+}
+
+int JsonReader::get() {
+    int c = peek();
+    if (c == -1) {
+        return -1;
+    }
+    ++pos;
+    if (c == '\n') {
+        ++line;
+        column = 1;
+    } else {
+        ++column;
+    }
+    return c;
+}
+
+void JsonReader::skip_whitespace() {
+    for (int c = peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r'; c = peek()) {
+        get();
+    }
+}
+
+bool JsonReader::fail(const std::string& message) {
+    fail_line = line;
+    fail_column = column;
+    std::ostringstream oss;
+    oss << line << ":" << column << ": " << message;
+    last_error = oss.str();
+    return false;
+}
+
+bool JsonReader::handler_stopped(const JsonHandler& handler) {
+    return fail(handler.message().empty() ? "stopped by handler" : handler.message());
+}
+
+bool JsonReader::parse_value(JsonHandler& handler, size_t depth) {
+    int c = peek();
+    switch (c) {
+        case '{':
+            return parse_object(handler, depth + 1);
+        case '[':
+            return parse_array(handler, depth + 1);
+        case '"':
+            if (!parse_string()) {
+                return false;
+            }
+            return handler.string(scratch) || handler_stopped(handler);
+        case 't':
+            return parse_literal("true") && (handler.boolean(true) || handler_stopped(handler));
+        case 'f':
+            return parse_literal("false") && (handler.boolean(false) || handler_stopped(handler));
+        case 'n':
+            return parse_literal("null") && (handler.null() || handler_stopped(handler));
+        case -1:
+            return fail("unexpected end of input");
+        default:
+            if (c == '-' || is_digit(c)) {
+                double value = 0.0;
+                return parse_number(value) && (handler.number(value) || handler_stopped(handler));
+            }
+            return fail(std::string("unexpected character '") + static_cast<char>(c) + "'");
+    }
+}
+
+bool JsonReader::parse_object(JsonHandler& handler, size_t depth) {
+    if (depth > depth_limit) {
+        return fail("nesting too deep");
+    }
+    get();  // '{'
+    if (!handler.start_object()) {
+        return handler_stopped(handler);
+    }
+
+    skip_whitespace();
+    if (peek() == '}') {
+        get();
+        return handler.end_object() || handler_stopped(handler);
+    }
+
+    for (;;) {
+        if (peek() != '"') {
+            return fail("expected a string key");
+        }
+        if (!parse_string()) {
+            return false;
+        }
+        if (!handler.key(scratch)) {
+            return handler_stopped(handler);
+        }
+
+        skip_whitespace();
+        if (peek() != ':') {
+            return fail("expected ':' after key");
+        }
+        get();
+        skip_whitespace();
+        if (!parse_value(handler, depth)) {
+            return false;
+        }
+
+        skip_whitespace();
+        int c = peek();
+        if (c == ',') {
+            get();
+            skip_whitespace();
+        } else if (c == '}') {
+            get();
+            return handler.end_object() || handler_stopped(handler);
+        } else {
+            return fail("expected ',' or '}' in object");
+        }
+    }
+}
+
+bool JsonReader::parse_array(JsonHandler& handler, size_t depth) {
+    if (depth > depth_limit) {
+        return fail("nesting too deep");
+    }
+    get();  // '['
+    if (!handler.start_array()) {
+        return handler_stopped(handler);
+    }
+
+    skip_whitespace();
+    if (peek() == ']') {
+        get();
+        return handler.end_array() || handler_stopped(handler);
+    }
+
+    for (;;) {
+        if (!parse_value(handler, depth)) {
+            return false;
+        }
+
+        skip_whitespace();
+        int c = peek();
+        if (c == ',') {
+            get();
+            skip_whitespace();
+        } else if (c == ']') {
+            get();
+            return handler.end_array() || handler_stopped(handler);
+        } else {
+            return fail("expected ',' or ']' in array");
+        }
+    }
+}
+
+bool JsonReader::parse_string() {
+    get();  // opening quote
+    scratch.clear();
+    for (;;) {
+        // Copy the run of plain bytes in the current chunk at once
+        const char* run_begin = pos;
+        while (pos != end && *pos != '"' && *pos != '\\' &&
+               static_cast<unsigned char>(*pos) >= 0x20) {
+            ++pos;
+        }
+        column += static_cast<size_t>(pos - run_begin);
+        scratch.append(run_begin, pos);
+
+        int c = peek();
+        if (c == -1) {
+            return fail("unterminated string");
+        }
+        if (c == '"') {
+            get();
+            return true;
+        }
+        if (c < 0x20) {
+            return fail("control character in string");
+        }
+        if (c != '\\') {
+            continue;  // chunk boundary
+        }
+
+        get();  // backslash
+        int escape = peek();
+        switch (escape) {
+            case '"': scratch.push_back('"'); break;
+            case '\\': scratch.push_back('\\'); break;
+            case '/': scratch.push_back('/'); break;
+            case 'b': scratch.push_back('\b'); break;
+            case 'f': scratch.push_back('\f'); break;
+            case 'n': scratch.push_back('\n'); break;
+            case 'r': scratch.push_back('\r'); break;
+            case 't': scratch.push_back('\t'); break;
+            case 'u': {
+                get();
+                uint32_t code = 0;
+                if (!parse_hex4(code)) {
+                    return false;
+                }
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // High surrogate: a low surrogate escape must follow
+                    uint32_t low = 0;
+                    if (get() != '\\' || get() != 'u') {
+                        return fail("unpaired surrogate in \\u escape");
+                    }
+                    if (!parse_hex4(low)) {
+                        return false;
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return fail("unpaired surrogate in \\u escape");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                    return fail("unpaired surrogate in \\u escape");
+                }
+                append_utf8(scratch, code);
+                continue;
+            }
+            default:
+                return fail("invalid escape in string");
+        }
+        get();
+    }
+}
+
+bool JsonReader::parse_hex4(uint32_t& code) {
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+        int c = peek();
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return fail("expected 4 hex digits in \\u escape");
+        }
+        get();
+        code = (code << 4) | digit;
+    }
+    return true;
+}
+
+bool JsonReader::parse_number(double& value) {
+    // Validate the RFC 8259 grammar while collecting the text:
+    // -? (0 | [1-9][0-9]*) (. [0-9]+)? ([eE] [+-]? [0-9]+)?
+    scratch.clear();
+    auto take = [this] { scratch.push_back(static_cast<char>(get())); };
+    auto digits = [this, &take] {
+        if (!is_digit(peek())) {
+            return false;
+        }
+        while (is_digit(peek())) {
+            take();
+        }
+        return true;
+    };
+
+    if (peek() == '-') {
+        take();
+    }
+    if (peek() == '0') {
+        take();
+    } else if (!digits()) {
+        return fail("invalid number");
+    }
+    if (peek() == '.') {
+        take();
+        if (!digits()) {
+            return fail("expected digits after '.'");
+        }
+    }
+    if (peek() == 'e' || peek() == 'E') {
+        take();
+        if (peek() == '+' || peek() == '-') {
+            take();
+        }
+        if (!digits()) {
+            return fail("expected digits in exponent");
+        }
+    }
+
+    value = std::strtod(scratch.c_str(), nullptr);
+    return true;
+}
+
+bool JsonReader::parse_literal(const char* word) {
+    for (const char* p = word; *p != '\0'; ++p) {
+        if (peek() != static_cast<unsigned char>(*p)) {
+            return fail(std::string("invalid literal, expected '") + word + "'");
+        }
+        get();
+    }
+    return true;
+}
@@ -0,0 +1,202 @@
+#include "../include/knn_index.hpp"
+#include "../include/hnsw_search.hpp"
+#include "../include/published.hpp"
+#include "../include/similarity_kernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// kDefaultImagePath; nullptr if it is missing or invalid
+std::shared_ptr<const KnnIndex> load_deployed() {
+    auto index = std::make_shared<KnnIndex>();
+    if (index->load(KnnIndex::kDefaultImagePath)) {
+        return index;
+    }
+    return nullptr;
+}
+
+Published<KnnIndex>& published_index() {
+    static Published<KnnIndex> published([] {
+        std::shared_ptr<const KnnIndex> index = load_deployed();
+        return index ? index : std::make_shared<const KnnIndex>();
+    }());
+    return published;
+}
+
+}  // namespace
+
+std::shared_ptr<const KnnIndex> KnnIndex::current() {
+    return published_index().acquire();
+}
+
+uint64_t KnnIndex::version() {
+    return published_index().version();
+}
+
+void KnnIndex::publish(std::shared_ptr<const KnnIndex> index) {
+    published_index().publish(std::move(index));
+}
+
+bool KnnIndex::reload() {
+    std::shared_ptr<const KnnIndex> index = load_deployed();
+    if (!index) {
+        return false;
+    }
+    publish(std::move(index));
+    return true;
+}
+
+bool KnnIndex::load(const std::string& image_path) {
+    MappedFile mapped;
+    if (!mapped.open(image_path) || !validate(mapped.data(), mapped.size())) {
+        return false;
+    }
+    file = std::move(mapped);
+    owned.clear();
+    attach(file.data());
+    return true;
+}
+
+bool KnnIndex::load_image(std::vector<uint8_t> image) {
+    if (!validate(image.data(), image.size())) {
+        return false;
+    }
+    owned = std::move(image);
+    file.close();
+    attach(owned.data());
+    return true;
+}
+
+bool KnnIndex::validate(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(KnnImageHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(KnnImageHeader) != 0) {
+        return false;
+    }
+    const auto& header = *reinterpret_cast<const KnnImageHeader*>(data);
+    if (std::memcmp(header.magic, kKnnImageMagic, sizeof(header.magic)) != 0 ||
+        header.version != kKnnImageVersion || header.total_size != size ||
+        header.count == 0 || header.dimension == 0 || header.m == 0 ||
+        header.entry_point >= header.count ||
+        header.space != static_cast<uint32_t>(KnnSpace::WordVectors)) {
+        return false;
+    }
+
+    auto section_fits = [size](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t count = header.count;
+    const uint64_t m = header.m;
+    if (!section_fits(header.vectors, 4 * count * header.dimension) ||
+        !section_fits(header.ratings, 4 * count) ||
+        !section_fits(header.levels, count) ||
+        !section_fits(header.links, 4 * count * (2 * m + 1)) ||
+        !section_fits(header.upper_offsets, 4 * (count + 1))) {
+        return false;
+    }
+
+    // Levels must match the upper blocks, and every link must name a node
+    // present on the link's level, so search() needs no bounds checks
+    const uint8_t* levels = data + header.levels;
+    const auto* upper_offsets = reinterpret_cast<const uint32_t*>(data + header.upper_offsets);
+    if (upper_offsets[0] != 0 || levels[header.entry_point] != header.max_level ||
+        !section_fits(header.upper_links, 4 * static_cast<uint64_t>(upper_offsets[count]) * (m + 1))) {
+        return false;
+    }
+    auto links_valid = [&](const uint32_t* block, uint64_t capacity, uint32_t level) {
+        if (block[0] > capacity) {
+            return false;
+        }
+        for (uint32_t i = 1; i <= block[0]; ++i) {
+            if (block[i] >= count || levels[block[i]] < level) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const auto* links = reinterpret_cast<const uint32_t*>(data + header.links);
+    const auto* upper_links = reinterpret_cast<const uint32_t*>(data + header.upper_links);
+    for (uint64_t n = 0; n < count; ++n) {
+        if (levels[n] > header.max_level ||
+            upper_offsets[n + 1] < upper_offsets[n] ||
+            upper_offsets[n + 1] - upper_offsets[n] != levels[n] ||
+            !links_valid(links + n * (2 * m + 1), 2 * m, 0)) {
+            return false;
+        }
+    }
+    for (uint64_t n = 0; n < count; ++n) {
+        for (uint32_t level = 1; level <= levels[n]; ++level) {
+            const uint64_t block = upper_offsets[n] + level - 1;
+            if (!links_valid(upper_links + block * (m + 1), m, level)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void KnnIndex::attach(const uint8_t* data) {
+    const auto& header = *reinterpret_cast<const KnnImageHeader*>(data);
+
+    vectors = reinterpret_cast<const float*>(data + header.vectors);
+    ratings = reinterpret_cast<const float*>(data + header.ratings);
+    links = reinterpret_cast<const uint32_t*>(data + header.links);
+    upper_offsets = reinterpret_cast<const uint32_t*>(data + header.upper_offsets);
+    upper_links = reinterpret_cast<const uint32_t*>(data + header.upper_links);
+    dim = header.dimension;
+    total = header.count;
+    link_capacity = header.m;
+    max_level = header.max_level;
+    entry_point = header.entry_point;
+    ef_default = header.ef_search;
+    model_fingerprint = header.embeddings_fingerprint;
+    embedding_space = static_cast<KnnSpace>(header.space);
+}
+
+float KnnIndex::similarity(const float* query, uint32_t id) const {
+    return SimilarityKernel::dot(query, vector(id), dim);
+}
+
+void KnnIndex::neighbors(uint32_t id, uint32_t level, std::vector<uint32_t>& out) const {
+    const uint32_t* block = (level == 0)
+        ? links + static_cast<size_t>(id) * (2 * link_capacity + 1)
+        : upper_links + (static_cast<size_t>(upper_offsets[id]) + level - 1) * (link_capacity + 1);
+    out.assign(block + 1, block + 1 + block[0]);
+}
+
+size_t KnnIndex::search(const float* query, size_t k, size_t ef, KnnNeighbor* out) const {
+    if (empty() || k == 0) {
+        return 0;
+    }
+
+    // Stored vectors are unit length; a unit query makes the dot products
+    // cosine similarities
+    static thread_local std::vector<float> unit;
+    unit.assign(query, query + dim);
+    double norm = 0.0;
+    for (float v : unit) {
+        norm += static_cast<double>(v) * v;
+    }
+    if (!(norm > 0.0) || !std::isfinite(norm)) {
+        return 0;
+    }
+    const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+    for (float& v : unit) {
+        v *= scale;
+    }
+
+    HnswCandidate entry{similarity(unit.data(), entry_point), entry_point};
+    for (uint32_t level = max_level; level > 0; --level) {
+        entry = hnsw_greedy_descent(*this, unit.data(), entry, level);
+    }
+
+    static thread_local std::vector<HnswCandidate> found;
+    hnsw_search_layer(*this, unit.data(), entry, std::max(ef, k), 0, found);
+
+    const size_t n = std::min(k, found.size());
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = KnnNeighbor{found[i].id, found[i].similarity};
+    }
+    return n;
+}
@@ -0,0 +1,286 @@
+#include "../include/knn_index_builder.hpp"
+#include "../include/hnsw_search.hpp"
+#include "../include/similarity_kernel.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+
+namespace {
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+size_t align64(size_t offset) {
+    return (offset + 63) & ~static_cast<size_t>(63);
+}
+
+// Levels above this are never drawn in practice (p < m^-15)
+constexpr uint32_t kMaxLevel = 15;
+
+/**
+ * The graph while it is being linked: the same link blocks as the image,
+ * with a lock per node so insertions run in parallel.
+ */
+class Construction {
+public:
+    Construction(const float* vectors, size_t dim, uint32_t count, uint32_t m,
+                 const std::vector<uint8_t>& levels)
+        : vectors(vectors), dim(dim), count(count), m(m), levels(levels),
+          upper_offsets(count + 1, 0), links(static_cast<size_t>(count) * (2 * m + 1), 0),
+          locks(new std::mutex[count]) {
+        for (uint32_t n = 0; n < count; ++n) {
+            upper_offsets[n + 1] = upper_offsets[n] + levels[n];
+        }
+        upper_links.assign(static_cast<size_t>(upper_offsets[count]) * (m + 1), 0);
+
+        // The first node is the entry point until a higher one arrives
+        entry = 0;
+        top_level = levels[0];
+    }
+
+    size_t size() const { return count; }
+
+    const float* vector(uint32_t id) const { return vectors + static_cast<size_t>(id) * dim; }
+
+    float similarity(const float* query, uint32_t id) const {
+        return SimilarityKernel::dot(query, vector(id), dim);
+    }
+
+    void neighbors(uint32_t id, uint32_t level, std::vector<uint32_t>& out) const {
+        std::lock_guard<std::mutex> lock(locks[id]);
+        const uint32_t* block = link_block(id, level);
+        out.assign(block + 1, block + 1 + block[0]);
+    }
+
+    void insert(uint32_t id, size_t ef_construction);
+
+    uint32_t entry_point() const { return entry; }
+    uint32_t max_level() const { return top_level; }
+    const std::vector<uint32_t>& level0_links() const { return links; }
+    const std::vector<uint32_t>& upper_block_offsets() const { return upper_offsets; }
+    const std::vector<uint32_t>& upper_level_links() const { return upper_links; }
+
+private:
+    const float* vectors;
+    size_t dim;
+    uint32_t count;
+    uint32_t m;
+    const std::vector<uint8_t>& levels;
+    std::vector<uint32_t> upper_offsets;
+    std::vector<uint32_t> links;
+    std::vector<uint32_t> upper_links;
+    std::unique_ptr<std::mutex[]> locks;
+
+    std::mutex entry_lock;
+    uint32_t entry;
+    uint32_t top_level;
+
+    uint32_t* link_block(uint32_t id, uint32_t level) {
+        return (level == 0)
+            ? links.data() + static_cast<size_t>(id) * (2 * m + 1)
+            : upper_links.data() + (static_cast<size_t>(upper_offsets[id]) + level - 1) * (m + 1);
+    }
+
+    const uint32_t* link_block(uint32_t id, uint32_t level) const {
+        return const_cast<Construction*>(this)->link_block(id, level);
+    }
+
+    void select_neighbors(std::vector<HnswCandidate>& candidates, size_t limit) const;
+    void link_back(uint32_t target, uint32_t id, uint32_t level);
+};
+
+void Construction::select_neighbors(std::vector<HnswCandidate>& candidates, size_t limit) const {
+    // candidates are closest first. Keep one only if no kept neighbor is
+    // closer to it than the base node is: a candidate behind a kept
+    // neighbor stays reachable through it.
+    std::vector<HnswCandidate> kept;
+    kept.reserve(limit);
+    for (const HnswCandidate& candidate : candidates) {
+        if (kept.size() == limit) {
+            break;
+        }
+        const float* v = vector(candidate.id);
+        bool diverse = true;
+        for (const HnswCandidate& other : kept) {
+            if (similarity(v, other.id) > candidate.similarity) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) {
+            kept.push_back(candidate);
+        }
+    }
+    candidates.swap(kept);
+}
+
+void Construction::link_back(uint32_t target, uint32_t id, uint32_t level) {
+    std::lock_guard<std::mutex> lock(locks[target]);
+    uint32_t* block = link_block(target, level);
+    const uint32_t capacity = (level == 0) ? 2 * m : m;
+    if (block[0] < capacity) {
+        block[1 + block[0]++] = id;
+        return;
+    }
+
+    // Full: re-select among the old links and the new node
+    const float* base = vector(target);
+    std::vector<HnswCandidate> candidates;
+    candidates.reserve(capacity + 1);
+    for (uint32_t i = 1; i <= block[0]; ++i) {
+        candidates.push_back(HnswCandidate{similarity(base, block[i]), block[i]});
+    }
+    candidates.push_back(HnswCandidate{similarity(base, id), id});
+    std::sort(candidates.begin(), candidates.end(),
+              [](const HnswCandidate& a, const HnswCandidate& b) { return a.similarity > b.similarity; });
+    select_neighbors(candidates, capacity);
+
+    block[0] = static_cast<uint32_t>(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        block[1 + i] = candidates[i].id;
+    }
+}
+
+void Construction::insert(uint32_t id, size_t ef_construction) {
+    const float* query = vector(id);
+    const uint32_t level = levels[id];
+
+    // A node that raises the top level holds the entry lock until it is
+    // linked and becomes the entry point (rare: about 1 node in m)
+    std::unique_lock<std::mutex> top(entry_lock);
+    const uint32_t start = entry;
+    const uint32_t start_level = top_level;
+    if (level <= start_level) {
+        top.unlock();
+    }
+
+    HnswCandidate current{similarity(query, start), start};
+    for (uint32_t l = start_level; l > level; --l) {
+        current = hnsw_greedy_descent(*this, query, current, l);
+    }
+
+    std::vector<HnswCandidate> found;
+    for (uint32_t l = std::min(level, start_level) + 1; l-- > 0;) {
+        hnsw_search_layer(*this, query, current, ef_construction, l, found);
+        current = found.front();
+        select_neighbors(found, m);
+
+        {
+            std::lock_guard<std::mutex> lock(locks[id]);
+            uint32_t* block = link_block(id, l);
+            block[0] = static_cast<uint32_t>(found.size());
+            for (size_t i = 0; i < found.size(); ++i) {
+                block[1 + i] = found[i].id;
+            }
+        }
+        for (const HnswCandidate& neighbor : found) {
+            link_back(neighbor.id, id, l);
+        }
+    }
+
+    if (level > start_level) {
+        entry = id;
+        top_level = level;
+    }
+}
+
+}  // namespace
+
+KnnIndexBuilder::KnnIndexBuilder(size_t dimension, KnnSpace space,
+                                 uint64_t embeddings_fingerprint)
+    : dim(dimension), embedding_space(space), model_fingerprint(embeddings_fingerprint) {}
+
+bool KnnIndexBuilder::add(const float* vector, float rating) {
+    double norm = 0.0;
+    for (size_t d = 0; d < dim; ++d) {
+        norm += static_cast<double>(vector[d]) * vector[d];
+    }
+    if (!(norm > 0.0) || !std::isfinite(norm)) {
+        last_error = "vector " + std::to_string(size()) + " is zero or not finite";
+        return false;
+    }
+    const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+    for (size_t d = 0; d < dim; ++d) {
+        vectors.push_back(vector[d] * scale);
+    }
+    ratings.push_back(std::isfinite(rating) ? std::max(-1.0f, std::min(1.0f, rating)) : 0.0f);
+    return true;
+}
+
+std::vector<uint8_t> KnnIndexBuilder::compile(const Options& options) const {
+    const uint32_t count = static_cast<uint32_t>(size());
+    if (count == 0 || dim == 0) {
+        return {};
+    }
+    const uint32_t m = static_cast<uint32_t>(std::max<size_t>(options.m, 2));
+
+    // Top level of each node: floor(-ln(u) / ln(m)), drawn up front so the
+    // levels do not depend on the insertion schedule
+    std::vector<uint8_t> levels(count);
+    std::mt19937_64 random(options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double scale = 1.0 / std::log(static_cast<double>(m));
+    for (uint8_t& level : levels) {
+        const double u = 1.0 - uniform(random);  // (0, 1]
+        level = static_cast<uint8_t>(std::min<double>(kMaxLevel, std::floor(-std::log(u) * scale)));
+    }
+
+    Construction graph(vectors.data(), dim, count, m, levels);
+    const size_t ef_construction = std::max<size_t>(options.ef_construction, m);
+    if (count > 1) {
+        ThreadPool pool(options.threads);
+        pool.parallel_for(count - 1, [&](size_t, size_t index) {
+            graph.insert(static_cast<uint32_t>(index + 1), ef_construction);
+        });
+    }
+
+    // Section layout
+    const std::vector<uint32_t>& links = graph.level0_links();
+    const std::vector<uint32_t>& upper_offsets = graph.upper_block_offsets();
+    const std::vector<uint32_t>& upper_links = graph.upper_level_links();
+
+    KnnImageHeader header{};
+    std::memcpy(header.magic, kKnnImageMagic, sizeof(header.magic));
+    header.version = kKnnImageVersion;
+    header.dimension = static_cast<uint32_t>(dim);
+    header.count = count;
+    header.space = static_cast<uint32_t>(embedding_space);
+    header.m = m;
+    header.max_level = graph.max_level();
+    header.entry_point = graph.entry_point();
+    header.ef_search = static_cast<uint32_t>(std::max<size_t>(options.ef_search, 1));
+    header.embeddings_fingerprint = model_fingerprint;
+
+    size_t offset = align64(sizeof(KnnImageHeader));
+    header.vectors = offset;
+    offset = align8(offset + sizeof(float) * vectors.size());
+    header.ratings = offset;
+    offset = align8(offset + sizeof(float) * ratings.size());
+    header.levels = offset;
+    offset = align8(offset + levels.size());
+    header.links = offset;
+    offset = align8(offset + sizeof(uint32_t) * links.size());
+    header.upper_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * upper_offsets.size());
+    header.upper_links = offset;
+    offset = align8(offset + sizeof(uint32_t) * upper_links.size());
+    header.total_size = offset;
+
+    std::vector<uint8_t> image(offset, 0);
+    uint8_t* base = image.data();
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base + header.vectors, vectors.data(), sizeof(float) * vectors.size());
+    std::memcpy(base + header.ratings, ratings.data(), sizeof(float) * ratings.size());
+    std::memcpy(base + header.levels, levels.data(), levels.size());
+    std::memcpy(base + header.links, links.data(), sizeof(uint32_t) * links.size());
+    std::memcpy(base + header.upper_offsets, upper_offsets.data(),
+                sizeof(uint32_t) * upper_offsets.size());
+    std::memcpy(base + header.upper_links, upper_links.data(),
+                sizeof(uint32_t) * upper_links.size());
+    return image;
+}
@@ -0,0 +1,185 @@
+#include "../include/lexicon.hpp"
+#include "../include/lexicon_builder.hpp"
+#include "../include/published.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// kDefaultImagePath, or the sources compiled in memory; nullptr if neither loads
+std::shared_ptr<const Lexicon> load_deployed() {
+    auto lexicon = std::make_shared<Lexicon>();
+    if (lexicon->load(Lexicon::kDefaultImagePath)) {
+        return lexicon;
+    }
+    // No compiled image deployed: compile the source tables in memory
+    LexiconBuilder builder;
+    if (builder.load_directory(Lexicon::kDefaultSourceDir) && lexicon->load_image(builder.compile())) {
+        return lexicon;
+    }
+    return nullptr;
+}
+
+Published<Lexicon>& published_lexicon() {
+    static Published<Lexicon> published([] {
+        std::shared_ptr<const Lexicon> lexicon = load_deployed();
+        return lexicon ? lexicon : std::make_shared<const Lexicon>();
+    }());
+    return published;
+}
+
+}  // namespace
+
+Lexicon::Lexicon() {
+    load_image(LexiconBuilder().compile());
+}
+
+std::shared_ptr<const Lexicon> Lexicon::current() {
+    return published_lexicon().acquire();
+}
+
+std::shared_ptr<const Lexicon> Lexicon::current(uint64_t& version) {
+    return published_lexicon().acquire(version);
+}
+
+uint64_t Lexicon::version() {
+    return published_lexicon().version();
+}
+
+void Lexicon::publish(std::shared_ptr<const Lexicon> lexicon) {
+    published_lexicon().publish(std::move(lexicon));
+}
+
+bool Lexicon::reload() {
+    std::shared_ptr<const Lexicon> lexicon = load_deployed();
+    if (!lexicon) {
+        return false;
+    }
+    publish(std::move(lexicon));
+    return true;
+}
+
+bool Lexicon::load(const std::string& image_path) {
+    MappedFile mapped;
+    if (!mapped.open(image_path) || !validate(mapped.data(), mapped.size())) {
+        return false;
+    }
+    file = std::move(mapped);
+    owned.clear();
+    attach(file.data());
+    return true;
+}
+
+bool Lexicon::load_image(std::vector<uint8_t> image) {
+    if (!validate(image.data(), image.size())) {
+        return false;
+    }
+    owned = std::move(image);
+    file.close();
+    attach(owned.data());
+    return true;
+}
+
+bool Lexicon::validate(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(LexiconImageHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(LexiconImageHeader) != 0) {
+        return false;
+    }
+    const auto& header = *reinterpret_cast<const LexiconImageHeader*>(data);
+    if (std::memcmp(header.magic, kLexiconImageMagic, sizeof(header.magic)) != 0 ||
+        header.version != kLexiconImageVersion || header.total_size != size) {
+        return false;
+    }
+
+    auto section_fits = [size](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t slots = header.slot_count;
+    if (!section_fits(header.word_offsets, 4 * (slots + 2)) ||
+        !section_fits(header.displacements, 4ull * header.bucket_count) ||
+        !section_fits(header.entries, sizeof(LexiconEntry) * (slots + 1)) ||
+        !section_fits(header.phrase_edges, sizeof(PhraseEdge) * header.phrase_slot_count) ||
+        !section_fits(header.entity_offsets, 4ull * (header.entity_count + 1ull)) ||
+        !section_fits(header.entity_ideologies, header.entity_count) ||
+        (slots > 0 && header.bucket_count == 0) ||
+        (header.phrase_slot_count & (header.phrase_slot_count - 1)) != 0) {
+        return false;
+    }
+
+    // Blob lengths come from the last offset of each table
+    const auto* word_offsets = reinterpret_cast<const uint32_t*>(data + header.word_offsets);
+    const auto* entity_offsets = reinterpret_cast<const uint32_t*>(data + header.entity_offsets);
+    if (!section_fits(header.word_blob, word_offsets[slots + 1]) ||
+        !section_fits(header.entity_blob, entity_offsets[header.entity_count])) {
+        return false;
+    }
+    for (uint64_t id = 0; id <= slots; ++id) {
+        if (word_offsets[id] > word_offsets[id + 1]) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header.entity_count; ++i) {
+        if (entity_offsets[i] > entity_offsets[i + 1]) {
+            return false;
+        }
+    }
+
+    // Ideologies are read straight into the enum
+    const uint8_t* ideologies = data + header.entity_ideologies;
+    for (uint32_t i = 0; i < header.entity_count; ++i) {
+        if (ideologies[i] > static_cast<uint8_t>(Ideology::Neutral)) {
+            return false;
+        }
+    }
+
+    // A lookup probes until an empty slot, so the phrase table needs one
+    const auto* phrase_edges = reinterpret_cast<const PhraseEdge*>(data + header.phrase_edges);
+    const PhraseEdge* phrase_end = phrase_edges + header.phrase_slot_count;
+    if (header.phrase_slot_count > 0 &&
+        std::none_of(phrase_edges, phrase_end, [](const PhraseEdge& edge) { return edge.to == 0; })) {
+        return false;
+    }
+
+    // States are word ids (1..slot_count) then one inner state per edge, so
+    // every edge must lead to an inner state that exists
+    const uint64_t edge_count = std::count_if(phrase_edges, phrase_end,
+                                              [](const PhraseEdge& edge) { return edge.to != 0; });
+    const uint64_t state_count = slots + 1 + edge_count;
+    for (const PhraseEdge* edge = phrase_edges; edge != phrase_end; ++edge) {
+        if (edge->to != 0 &&
+            (edge->to <= slots || edge->to >= state_count || edge->from >= state_count ||
+             edge->token > slots)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Lexicon::attach(const uint8_t* data) {
+    const auto& header = *reinterpret_cast<const LexiconImageHeader*>(data);
+
+    vocab = Vocabulary(reinterpret_cast<const uint32_t*>(data + header.word_offsets),
+                       reinterpret_cast<const char*>(data + header.word_blob),
+                       reinterpret_cast<const uint32_t*>(data + header.displacements),
+                       header.slot_count, header.bucket_count);
+    entries = reinterpret_cast<const LexiconEntry*>(data + header.entries);
+    phrase_trie = PhraseTrie(reinterpret_cast<const PhraseEdge*>(data + header.phrase_edges),
+                             header.phrase_slot_count);
+    entity_offsets = reinterpret_cast<const uint32_t*>(data + header.entity_offsets);
+    entity_blob = reinterpret_cast<const char*>(data + header.entity_blob);
+    entity_ideologies = reinterpret_cast<const Ideology*>(data + header.entity_ideologies);
+    entity_total = header.entity_count;
+
+    // The automaton is cheap to build from the name table (no parsing involved)
+    EntityMatcher entity_automaton;
+    for (uint32_t i = 0; i < entity_total; ++i) {
+        entity_automaton.add(entity_name(i), i);
+    }
+    entity_automaton.build();
+    matcher = std::move(entity_automaton);
+}
+
+std::string_view Lexicon::entity_name(uint32_t index) const {
+    return std::string_view(entity_blob + entity_offsets[index],
+                            entity_offsets[index + 1] - entity_offsets[index]);
+}
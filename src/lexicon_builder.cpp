@@ -0,0 +1,353 @@
+#include "../include/lexicon_builder.hpp"
+#include "../include/hash.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+std::string lowercase(std::string_view text) {
+    std::string out(text);
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c | 0x20);
+        }
+    }
+    return out;
+}
+
+// Split a line on tabs into fields (views into line)
+std::vector<std::string_view> split_fields(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string_view::npos ? tab : tab - start));
+        if (tab == std::string_view::npos) {
+            return fields;
+        }
+        start = tab + 1;
+    }
+}
+
+// Split a phrase on spaces, skipping empty words
+std::vector<std::string_view> split_words(std::string_view phrase) {
+    std::vector<std::string_view> result;
+    size_t start = 0;
+    while (start < phrase.size()) {
+        size_t space = phrase.find(' ', start);
+        size_t end = (space == std::string_view::npos) ? phrase.size() : space;
+        if (end > start) {
+            result.push_back(phrase.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return result;
+}
+
+bool parse_float(std::string_view text, float& out) {
+    std::string value(text);
+    char* end = nullptr;
+    out = std::strtof(value.c_str(), &end);
+    return !value.empty() && end == value.c_str() + value.size();
+}
+
+bool parse_int(std::string_view text, long& out) {
+    std::string value(text);
+    char* end = nullptr;
+    out = std::strtol(value.c_str(), &end, 10);
+    return !value.empty() && end == value.c_str() + value.size();
+}
+
+// Read a TSV file line by line; returns -1 if absent, 0 on error, 1 on success
+template <typename Fn>
+int read_tsv(const std::string& path, Fn&& on_fields) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return -1;
+    }
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (!on_fields(split_fields(line), line_number)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+}  // namespace
+
+bool LexiconBuilder::fail(const std::string& path, size_t line, const std::string& message) {
+    last_error = path + ":" + std::to_string(line) + ": " + message;
+    return false;
+}
+
+bool LexiconBuilder::load_directory(const std::string& dir) {
+    last_error.clear();
+    int files_found = 0;
+
+    auto run = [&](const char* name, auto&& on_fields) {
+        std::string path = dir + "/" + name;
+        int status = read_tsv(path, [&](const std::vector<std::string_view>& fields, size_t line) {
+            return on_fields(path, fields, line);
+        });
+        files_found += (status >= 0);
+        return status != 0;
+    };
+
+    bool ok =
+        run("sentiment.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            float polarity;
+            if (fields.size() < 2 || !parse_float(fields[1], polarity)) {
+                return fail(path, line, "expected: word <TAB> polarity");
+            }
+            word(fields[0]).sentiment = polarity;
+            return true;
+        }) &&
+        run("emotion.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            float intensity;
+            if (fields.size() < 2 || !parse_float(fields[1], intensity)) {
+                return fail(path, line, "expected: word <TAB> intensity");
+            }
+            word(fields[0]).emotion = intensity;
+            return true;
+        }) &&
+        run("frames.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            long weight;
+            if (fields.size() < 3 || !parse_int(fields[2], weight) || weight < 0 || weight > 255) {
+                return fail(path, line, "expected: phrase <TAB> left|right <TAB> weight");
+            }
+            int8_t direction = (fields[1] == "left") ? -1 : (fields[1] == "right") ? 1 : 0;
+            if (direction == 0) {
+                return fail(path, line, "direction must be 'left' or 'right'");
+            }
+            std::vector<std::string_view> phrase_words = split_words(fields[0]);
+            if (phrase_words.empty() || phrase_words.size() > PhraseTrie::kMaxWords) {
+                return fail(path, line, "frames are one to five words");
+            }
+            if (phrase_words.size() == 1) {
+                LexiconEntry& entry = word(phrase_words[0]);
+                entry.frame_direction = direction;
+                entry.frame_weight = static_cast<uint8_t>(weight);
+            } else {
+                add_phrase(phrase_words, direction, static_cast<uint8_t>(weight));
+            }
+            return true;
+        }) &&
+        run("context.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            if (fields.size() < 2 || (fields[1] != "negative" && fields[1] != "positive")) {
+                return fail(path, line, "expected: word <TAB> negative|positive");
+            }
+            word(fields[0]).context |= (fields[1] == "negative") ? kNegativeContext : kPositiveContext;
+            return true;
+        }) &&
+        run("semantic.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            long dimension;
+            float weight;
+            if (fields.size() < 3 || !parse_int(fields[1], dimension) ||
+                dimension < 0 || dimension > 127 || !parse_float(fields[2], weight)) {
+                return fail(path, line, "expected: word <TAB> dimension <TAB> weight");
+            }
+            LexiconEntry& entry = word(fields[0]);
+            entry.semantic_dimension = static_cast<int8_t>(dimension);
+            entry.semantic_weight = weight;
+            return true;
+        }) &&
+        run("entities.tsv", [&](const std::string& path, const auto& fields, size_t line) {
+            if (fields.size() < 2) {
+                return fail(path, line, "expected: name <TAB> left|right|neutral");
+            }
+            Ideology ideology = (fields[1] == "left")    ? Ideology::Left
+                              : (fields[1] == "right")   ? Ideology::Right
+                              : (fields[1] == "neutral") ? Ideology::Neutral
+                                                         : Ideology::Unknown;
+            add_entity(fields[0], ideology);
+            return true;
+        });
+
+    if (ok && files_found == 0) {
+        last_error = dir + ": no lexicon source files found";
+        return false;
+    }
+    return ok;
+}
+
+uint32_t LexiconBuilder::intern(std::string_view word) {
+    std::string key = lowercase(word);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        return it->second;
+    }
+    uint32_t position = static_cast<uint32_t>(words.size());
+    index.emplace(key, position);
+    words.push_back(std::move(key));
+    features.emplace_back();
+    return position;
+}
+
+LexiconEntry& LexiconBuilder::word(std::string_view word) {
+    return features[intern(word)];
+}
+
+void LexiconBuilder::add_phrase(const std::vector<std::string_view>& phrase_words,
+                                int8_t direction, uint8_t weight) {
+    std::vector<uint32_t> key;
+    key.reserve(phrase_words.size());
+    for (std::string_view w : phrase_words) {
+        key.push_back(intern(w));
+    }
+    auto [it, inserted] = phrase_index.emplace(key, static_cast<uint32_t>(phrases.size()));
+    if (inserted) {
+        phrases.push_back(Phrase{std::move(key), LexiconPhrase{direction, weight}});
+    } else {
+        phrases[it->second].frame = LexiconPhrase{direction, weight};
+    }
+}
+
+void LexiconBuilder::add_entity(std::string_view name, Ideology ideology) {
+    entities.push_back(Entity{lowercase(name), ideology});
+}
+
+std::vector<uint8_t> LexiconBuilder::compile() const {
+    const uint32_t n = static_cast<uint32_t>(words.size());
+
+    std::vector<uint64_t> hashes(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        hashes[i] = hash_bytes(words[i]);
+    }
+    const VocabularyLayout layout = Vocabulary::layout(hashes);
+    const uint32_t slot_count = layout.slot_count;
+    const uint32_t bucket_count = layout.bucket_count;
+    const std::vector<uint32_t>& displacements = layout.displacements;
+    const std::vector<uint32_t>& slot_word = layout.slot_key;
+
+    // Word index -> id
+    std::vector<uint32_t> word_id(n, 0);
+    for (uint32_t slot = 0; slot < slot_count; ++slot) {
+        if (slot_word[slot] != 0) {
+            word_id[slot_word[slot] - 1] = slot + 1;
+        }
+    }
+
+    // Section layout
+    LexiconImageHeader header{};
+    std::memcpy(header.magic, kLexiconImageMagic, sizeof(header.magic));
+    header.version = kLexiconImageVersion;
+    header.slot_count = slot_count;
+    header.bucket_count = bucket_count;
+
+    // Phrase trie: the state after the first word is its id, inner states
+    // are numbered from slot_count + 1; shared prefixes share states
+    std::vector<PhraseEdge> edges;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> edge_index;  // (from, token) -> edge
+    for (const auto& phrase : phrases) {
+        uint32_t state = word_id[phrase.words[0]];
+        for (size_t k = 1; k < phrase.words.size(); ++k) {
+            uint32_t token = word_id[phrase.words[k]];
+            auto [it, inserted] = edge_index.emplace(std::make_pair(state, token),
+                                                     static_cast<uint32_t>(edges.size()));
+            if (inserted) {
+                PhraseEdge edge{};
+                edge.from = state;
+                edge.token = token;
+                edge.to = slot_count + 1 + static_cast<uint32_t>(edges.size());
+                edges.push_back(edge);
+            }
+            state = edges[it->second].to;
+            if (k + 1 == phrase.words.size()) {
+                edges[it->second].frame = phrase.frame;
+            }
+        }
+    }
+    const std::vector<PhraseEdge> phrase_table = PhraseTrie::layout(edges);
+    header.phrase_slot_count = static_cast<uint32_t>(phrase_table.size());
+    header.entity_count = static_cast<uint32_t>(entities.size());
+
+    size_t word_blob_size = 0;
+    for (const auto& w : words) {
+        word_blob_size += w.size();
+    }
+    size_t entity_blob_size = 0;
+    for (const auto& e : entities) {
+        entity_blob_size += e.name.size();
+    }
+
+    size_t offset = align8(sizeof(LexiconImageHeader));
+    header.word_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * (static_cast<size_t>(slot_count) + 2));
+    header.word_blob = offset;
+    offset = align8(offset + word_blob_size);
+    header.displacements = offset;
+    offset = align8(offset + sizeof(uint32_t) * bucket_count);
+    header.entries = offset;
+    offset = align8(offset + sizeof(LexiconEntry) * (static_cast<size_t>(slot_count) + 1));
+    header.phrase_edges = offset;
+    offset = align8(offset + sizeof(PhraseEdge) * phrase_table.size());
+    header.entity_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * (entities.size() + 1));
+    header.entity_blob = offset;
+    offset = align8(offset + entity_blob_size);
+    header.entity_ideologies = offset;
+    offset = align8(offset + entities.size());
+    header.total_size = offset;
+
+    std::vector<uint8_t> image(offset, 0);
+    uint8_t* base = image.data();
+    std::memcpy(base, &header, sizeof(header));
+
+    // Words in id order; empty slots are zero-length
+    auto* word_offsets = reinterpret_cast<uint32_t*>(base + header.word_offsets);
+    char* word_blob = reinterpret_cast<char*>(base + header.word_blob);
+    uint32_t cursor = 0;
+    word_offsets[0] = 0;
+    for (uint32_t id = 1; id <= slot_count; ++id) {
+        word_offsets[id] = cursor;
+        if (slot_word[id - 1] != 0) {
+            const std::string& w = words[slot_word[id - 1] - 1];
+            std::memcpy(word_blob + cursor, w.data(), w.size());
+            cursor += static_cast<uint32_t>(w.size());
+        }
+    }
+    word_offsets[slot_count + 1] = cursor;
+
+    if (bucket_count > 0) {
+        std::memcpy(base + header.displacements, displacements.data(), sizeof(uint32_t) * bucket_count);
+    }
+
+    auto* entries = reinterpret_cast<LexiconEntry*>(base + header.entries);
+    entries[0] = LexiconEntry{};
+    for (uint32_t id = 1; id <= slot_count; ++id) {
+        entries[id] = (slot_word[id - 1] != 0) ? features[slot_word[id - 1] - 1] : LexiconEntry{};
+    }
+
+    if (!phrase_table.empty()) {
+        std::memcpy(base + header.phrase_edges, phrase_table.data(),
+                    sizeof(PhraseEdge) * phrase_table.size());
+    }
+
+    auto* entity_offsets = reinterpret_cast<uint32_t*>(base + header.entity_offsets);
+    char* entity_blob = reinterpret_cast<char*>(base + header.entity_blob);
+    auto* entity_ideologies = base + header.entity_ideologies;
+    cursor = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        entity_offsets[i] = cursor;
+        std::memcpy(entity_blob + cursor, entities[i].name.data(), entities[i].name.size());
+        cursor += static_cast<uint32_t>(entities[i].name.size());
+        entity_ideologies[i] = static_cast<uint8_t>(entities[i].ideology);
+    }
+    entity_offsets[entities.size()] = cursor;
+
+    return image;
+}
@@ -0,0 +1,155 @@
+#include "../include/mapped_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BIAS_DETECTOR_HAVE_MMAP 1
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        mapped = std::exchange(other.mapped, false);
+        buffer = std::move(other.buffer);  // heap storage moves without relocating
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef BIAS_DETECTOR_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    if (st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        bytes = static_cast<const uint8_t*>(addr);
+        length = static_cast<size_t>(st.st_size);
+        mapped = true;
+        return true;
+    }
+    ::close(fd);
+    // Empty files (and special files reporting size 0) go through the stream path
+#endif
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    length = buffer.size();
+    // Keep a non-null pointer even for empty files so is_open() reports success
+    buffer.reserve(1);
+    bytes = buffer.data();
+    mapped = false;
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef BIAS_DETECTOR_HAVE_MMAP
+    if (mapped && bytes != nullptr) {
+        ::munmap(const_cast<uint8_t*>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+void MappedFile::advise_sequential() const {
+#ifdef BIAS_DETECTOR_HAVE_MMAP
+    if (mapped && bytes != nullptr) {
+        ::madvise(const_cast<uint8_t*>(bytes), length, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::release(size_t offset, size_t count) const {
+#ifdef BIAS_DETECTOR_HAVE_MMAP
+    if (!mapped || bytes == nullptr || offset >= length) {
+        return;
+    }
+    // The mapping starts page aligned; only whole pages inside the range go
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t first = (offset + page - 1) / page * page;
+    const size_t last = std::min(offset + count, length) / page * page;
+    if (last > first) {
+        ::madvise(const_cast<uint8_t*>(bytes) + first, last - first, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)count;
+#endif
+}
+
+bool write_file_atomically(const std::string& path, const std::vector<uint8_t>& data) {
+    const std::string temporary = path + ".tmp";
+
+#ifdef BIAS_DETECTOR_HAVE_MMAP
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const uint8_t* next = data.data();
+    size_t left = data.size();
+    bool ok = true;
+    while (ok && left > 0) {
+        ssize_t written = ::write(fd, next, left);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = written > 0;
+        if (ok) {
+            next += written;
+            left -= static_cast<size_t>(written);
+        }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+#else
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.flush();
+    bool ok = static_cast<bool>(out);
+    out.close();
+#endif
+
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,258 @@
+#include "../include/near_duplicate_index.hpp"
+#include "../include/hash.hpp"
+#include <algorithm>
+#include <string_view>
+
+namespace {
+
+// Byte classes for the token walk: whitespace ends a token, alphanumerics
+// are kept (case folded), anything else is kept only between alphanumerics
+enum ByteClass : uint8_t { kSpace = 0, kAlnum = 1, kOther = 2 };
+
+struct ByteClassTable {
+    uint8_t cls[256];
+    uint8_t lower[256];
+
+    constexpr ByteClassTable() : cls(), lower() {
+        for (int c = 0; c < 256; ++c) {
+            bool space = c == ' ' || (c >= '\t' && c <= '\r');
+            bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            cls[c] = space ? kSpace : (alnum ? kAlnum : kOther);
+            lower[c] = static_cast<uint8_t>((c >= 'A' && c <= 'Z') ? (c | 0x20) : c);
+        }
+    }
+};
+
+constexpr ByteClassTable kBytes;
+
+inline unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned count = 0;
+    for (; x != 0; x &= x - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline uint64_t rotl(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+constexpr size_t kShingleTokens = 3;
+
+// Walks the tokens of title + " " + body (whitespace split, punctuation
+// trimmed, case folded) and folds 3-token shingles into SimHash counters
+class ShingleHasher {
+public:
+    void add_text(std::string_view text) {
+        // One pass per byte: an FNV-1a hash runs from the first alphanumeric
+        // byte of a token, and the value after its last alphanumeric byte is
+        // the token hash, so leading/trailing punctuation is trimmed exactly
+        // as in tokenize() without a second scan
+        const uint64_t kFnvOffset = 0xCBF29CE484222325ULL;
+        const uint64_t kFnvPrime = 0x100000001B3ULL;
+
+        bool in_token = false;
+        uint64_t running = kFnvOffset;
+        uint64_t token_hash = 0;
+        for (char raw : text) {
+            uint8_t c = static_cast<uint8_t>(raw);
+            uint8_t cls = kBytes.cls[c];
+            if (cls == kSpace) {
+                if (in_token) {
+                    add_token(token_hash);
+                    in_token = false;
+                    running = kFnvOffset;
+                }
+                continue;
+            }
+            if (!in_token && cls != kAlnum) {
+                continue;  // leading punctuation
+            }
+            running = (running ^ kBytes.lower[c]) * kFnvPrime;
+            if (cls == kAlnum) {
+                in_token = true;
+                token_hash = running;
+            }
+        }
+        if (in_token) {
+            add_token(token_hash);
+        }
+    }
+
+    uint64_t finish() {
+        // Texts shorter than one shingle still get a fingerprint
+        if (shingles == 0 && seen > 0) {
+            add_shingle(window[0] ^ window[1] ^ window[2]);
+        }
+        flush();
+
+        // Bit b is set when more than half of the shingles had it set
+        uint64_t fingerprint = 0;
+        for (unsigned bit = 0; bit < 64; ++bit) {
+            if (2 * ones[bit] > shingles) {
+                fingerprint |= uint64_t{1} << bit;
+            }
+        }
+        return fingerprint;
+    }
+
+private:
+    static constexpr uint64_t kLowBytes = 0x0101010101010101ULL;
+    static constexpr uint32_t kChunk = 255;  // max count a byte lane can hold
+
+    // Shingle hashes are buffered and counted a chunk at a time: byte j of
+    // lane k counts bit 8j + k, so each shingle costs 8 register adds
+    // instead of 64 counter updates
+    uint64_t chunk[kChunk];
+    uint32_t pending = 0;
+    uint32_t ones[64] = {};
+    uint64_t window[kShingleTokens] = {};
+    size_t seen = 0;
+    size_t shingles = 0;
+
+    void flush() {
+        uint64_t lanes[8] = {};
+        for (uint32_t i = 0; i < pending; ++i) {
+            uint64_t shingle = chunk[i];
+            for (unsigned k = 0; k < 8; ++k) {
+                lanes[k] += (shingle >> k) & kLowBytes;
+            }
+        }
+        for (unsigned k = 0; k < 8; ++k) {
+            for (unsigned j = 0; j < 8; ++j) {
+                ones[8 * j + k] += static_cast<uint32_t>((lanes[k] >> (8 * j)) & 0xFF);
+            }
+        }
+        pending = 0;
+    }
+
+    void add_token(uint64_t token_hash) {
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = hash_mix(token_hash);
+        if (++seen >= kShingleTokens) {
+            // Order-sensitive combination of the three (mixed) token hashes
+            add_shingle(rotl(window[0], 2) ^ rotl(window[1], 1) ^ window[2]);
+        }
+    }
+
+    void add_shingle(uint64_t shingle) {
+        chunk[pending] = hash_mix(shingle);
+        ++shingles;
+        if (++pending == kChunk) {
+            flush();
+        }
+    }
+};
+
+}  // namespace
+
+NearDuplicateIndex::NearDuplicateIndex(size_t capacity, unsigned max_distance)
+    : distance_limit(std::min(max_distance, 15u)),
+      band_count(distance_limit + 1),
+      band_bits(64 / band_count),
+      slots(capacity),
+      bands(band_count) {
+    for (auto& band : bands) {
+        band.reserve(capacity);
+    }
+}
+
+uint64_t NearDuplicateIndex::fingerprint(const ArticleInput& article) {
+    ShingleHasher hasher;
+    hasher.add_text(article.title);
+    hasher.add_text(article.body);
+    return hasher.finish();
+}
+
+uint64_t NearDuplicateIndex::band_value(uint64_t fingerprint, unsigned band) const {
+    // The last band takes the leftover bits when 64 is not a multiple
+    unsigned shift = band * band_bits;
+    unsigned bits = (band + 1 == band_count) ? 64 - shift : band_bits;
+    uint64_t mask = (bits >= 64) ? ~uint64_t{0} : ((uint64_t{1} << bits) - 1);
+    return (fingerprint >> shift) & mask;
+}
+
+bool NearDuplicateIndex::find(uint64_t fingerprint, uint64_t generation,
+                              ResultCache::Entry& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const Slot* best = nullptr;
+    unsigned best_distance = distance_limit + 1;
+    for (unsigned band = 0; band < band_count && best_distance > 0; ++band) {
+        auto it = bands[band].find(band_value(fingerprint, band));
+        if (it == bands[band].end()) {
+            continue;
+        }
+        for (const Candidate& candidate : it->second) {
+            if (candidate.generation != generation) {
+                continue;  // analyzed before a reload
+            }
+            unsigned distance = popcount64(candidate.fingerprint ^ fingerprint);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = &slots[candidate.slot];
+            }
+        }
+    }
+
+    if (best == nullptr) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    out = best->entry;
+    return true;
+}
+
+void NearDuplicateIndex::insert(uint64_t fingerprint, ResultCache::Entry entry) {
+    if (slots.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const uint32_t slot_index = static_cast<uint32_t>(next_slot);
+    Slot& slot = slots[slot_index];
+    next_slot = (next_slot + 1) % slots.size();
+
+    // Unlink the entry being replaced from its band buckets
+    if (slot.used) {
+        for (unsigned band = 0; band < band_count; ++band) {
+            auto it = bands[band].find(band_value(slot.fingerprint, band));
+            if (it == bands[band].end()) {
+                continue;
+            }
+            auto& bucket = it->second;
+            auto pos = std::find_if(bucket.begin(), bucket.end(),
+                                    [slot_index](const Candidate& c) { return c.slot == slot_index; });
+            if (pos != bucket.end()) {
+                *pos = bucket.back();
+                bucket.pop_back();
+            }
+            if (bucket.empty()) {
+                bands[band].erase(it);
+            }
+        }
+    } else {
+        slot.used = true;
+        ++used_slots;
+    }
+
+    const uint64_t generation = entry.generation;
+    slot.fingerprint = fingerprint;
+    slot.entry = std::move(entry);
+    for (unsigned band = 0; band < band_count; ++band) {
+        bands[band][band_value(fingerprint, band)].push_back(
+            Candidate{fingerprint, generation, slot_index});
+    }
+}
+
+NearDuplicateIndex::Stats NearDuplicateIndex::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Stats{hits, misses, used_slots, slots.size()};
+}
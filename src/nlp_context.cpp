@@ -1,29 +1,68 @@
 #include "../include/nlp_context.hpp"
 
-size_t NLPContext::token_count() const {
-    return tokens.size();
+void TokenFeatures::reset(size_t n) {
+    sentiment.assign(n, 0.0f);
+    emotion.assign(n, 0.0f);
+    frame_direction.assign(n, 0);
+    frame_weight.assign(n, 0);
+    context.assign(n, 0);
+    semantic_dimension.assign(n, -1);
+    semantic_weight.assign(n, 0.0f);
 }
 
-size_t NLPContext::entity_count() const {
-    return entities.size();
+uint32_t EntityTable::add_mention(uint32_t name, Ideology entity_ideology, TextSpan span) {
+    if (name >= slot_by_name.size()) {
+        slot_by_name.resize(name + 1, kNoSlot);
+    }
+
+    uint32_t entity = slot_by_name[name];
+    if (entity == kNoSlot) {
+        entity = static_cast<uint32_t>(size());
+        slot_by_name[name] = entity;
+        ideology.push_back(entity_ideology);
+        sentiment.push_back(0.0f);  // Updated by Preprocessor::compute_sentiment
+        emotion.push_back(0.0f);    // Updated by Preprocessor::compute_emotion
+        name_id.push_back(name);
+    }
+
+    mention_entity.push_back(entity);
+    mention_span.push_back(span);
+    return entity;
 }
 
-size_t NLPContext::sentence_count() const {
-    return sentences.size();
+void EntityTable::clear() {
+    // Only the slots this article touched need resetting
+    for (uint32_t name : name_id) {
+        slot_by_name[name] = kNoSlot;
+    }
+    ideology.clear();
+    sentiment.clear();
+    emotion.clear();
+    name_id.clear();
+    mention_entity.clear();
+    mention_span.clear();
 }
 
-void NLPContext::add_entity(const EntityMention& entity) {
-    entities.push_back(entity);
+void NLPContext::reset() {
+    text.clear();
+    tokens.clear();
+    token_ids.clear();
+    token_hashes.clear();
+    features.reset(0);
+    sentences.clear();
+    entities.clear();
+    embedding.clear();
+    reference_similarity.clear();
 }
 
-void NLPContext::cache_sentiment(const std::string& text, double score) {
-    sentiment_cache[text] = score;
+size_t NLPContext::token_count() const {
+    return tokens.size();
 }
 
-double NLPContext::get_cached_sentiment(const std::string& text) const {
-    auto it = sentiment_cache.find(text);
-    if (it != sentiment_cache.end()) {
-        return it->second;
-    }
-    return 0.0;  // default neutral
+size_t NLPContext::entity_count() const {
+    return entities.size();
+}
+
+size_t NLPContext::sentence_count() const {
+    return sentences.size();
 }
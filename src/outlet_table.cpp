@@ -0,0 +1,133 @@
+#include "../include/outlet_table.hpp"
+#include "../include/outlet_table_builder.hpp"
+#include "../include/published.hpp"
+#include <cstring>
+
+namespace {
+
+// kDefaultImagePath, or the JSON source parsed once; nullptr if neither loads
+std::shared_ptr<const OutletTable> load_deployed() {
+    auto table = std::make_shared<OutletTable>();
+    if (table->load(OutletTable::kDefaultImagePath)) {
+        return table;
+    }
+    // No compiled image deployed: parse the JSON source
+    OutletTableBuilder builder;
+    if (builder.load_json(OutletTable::kDefaultSourcePath) && table->load_image(builder.compile())) {
+        return table;
+    }
+    return nullptr;
+}
+
+Published<OutletTable>& published_outlets() {
+    static Published<OutletTable> published([] {
+        std::shared_ptr<const OutletTable> table = load_deployed();
+        return table ? table : std::make_shared<const OutletTable>();
+    }());
+    return published;
+}
+
+}  // namespace
+
+OutletTable::OutletTable() {
+    load_image(OutletTableBuilder().compile());
+}
+
+std::shared_ptr<const OutletTable> OutletTable::current() {
+    return published_outlets().acquire();
+}
+
+uint64_t OutletTable::version() {
+    return published_outlets().version();
+}
+
+void OutletTable::publish(std::shared_ptr<const OutletTable> table) {
+    published_outlets().publish(std::move(table));
+}
+
+bool OutletTable::reload() {
+    std::shared_ptr<const OutletTable> table = load_deployed();
+    if (!table) {
+        return false;
+    }
+    publish(std::move(table));
+    return true;
+}
+
+bool OutletTable::load(const std::string& image_path) {
+    MappedFile mapped;
+    if (!mapped.open(image_path) || !validate(mapped.data(), mapped.size())) {
+        return false;
+    }
+    file = std::move(mapped);
+    owned.clear();
+    attach(file.data());
+    return true;
+}
+
+bool OutletTable::load_image(std::vector<uint8_t> image) {
+    if (!validate(image.data(), image.size())) {
+        return false;
+    }
+    owned = std::move(image);
+    file.close();
+    attach(owned.data());
+    return true;
+}
+
+bool OutletTable::validate(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(OutletImageHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(OutletImageHeader) != 0) {
+        return false;
+    }
+    const auto& header = *reinterpret_cast<const OutletImageHeader*>(data);
+    if (std::memcmp(header.magic, kOutletImageMagic, sizeof(header.magic)) != 0 ||
+        header.version != kOutletImageVersion || header.total_size != size ||
+        header.outlet_count > header.slot_count) {
+        return false;
+    }
+
+    auto section_fits = [size](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t slots = header.slot_count;
+    if (!section_fits(header.domain_offsets, 4 * (slots + 2)) ||
+        !section_fits(header.displacements, 4ull * header.bucket_count) ||
+        !section_fits(header.scores, sizeof(double) * (slots + 1)) ||
+        (slots > 0 && header.bucket_count == 0)) {
+        return false;
+    }
+
+    // Blob length comes from the last offset
+    const auto* domain_offsets = reinterpret_cast<const uint32_t*>(data + header.domain_offsets);
+    if (!section_fits(header.domain_blob, domain_offsets[slots + 1])) {
+        return false;
+    }
+    for (uint64_t id = 0; id <= slots; ++id) {
+        if (domain_offsets[id] > domain_offsets[id + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void OutletTable::attach(const uint8_t* data) {
+    const auto& header = *reinterpret_cast<const OutletImageHeader*>(data);
+
+    domains = Vocabulary(reinterpret_cast<const uint32_t*>(data + header.domain_offsets),
+                         reinterpret_cast<const char*>(data + header.domain_blob),
+                         reinterpret_cast<const uint32_t*>(data + header.displacements),
+                         header.slot_count, header.bucket_count);
+    scores = reinterpret_cast<const double*>(data + header.scores);
+    outlet_total = header.outlet_count;
+
+    // The resolver trie is cheap to build from the domain table (no parsing involved)
+    DomainResolver host_resolver;
+    for (uint32_t id = 1; id <= header.slot_count; ++id) {
+        std::string_view name = domains.word(id);
+        if (!name.empty()) {
+            host_resolver.add(name, id);
+        }
+    }
+    resolver = std::move(host_resolver);
+}
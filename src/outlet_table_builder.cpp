@@ -0,0 +1,187 @@
+#include "../include/outlet_table_builder.hpp"
+#include "../include/hash.hpp"
+#include "../include/json_reader.hpp"
+#include <cstring>
+
+namespace {
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+// Streams the members of the top-level "outlets" object. A member's value
+// is either the score itself or an object carrying it under "score" (the
+// format OutletValidator writes); anything else is skipped.
+class OutletsHandler final : public JsonHandler {
+public:
+    explicit OutletsHandler(const std::function<void(std::string_view, double)>& on_outlet)
+        : emit(on_outlet) {}
+
+    bool found() const { return seen_outlets; }
+
+    bool start_object() override {
+        ++depth;
+        if (depth == 2 && top_key == "outlets") {
+            seen_outlets = in_outlets = true;
+        }
+        return true;
+    }
+
+    bool start_array() override {
+        ++depth;
+        if (depth == 2 && top_key == "outlets") {
+            return stop("\"outlets\" must be an object");
+        }
+        return true;
+    }
+
+    bool end_object() override { return leave(); }
+    bool end_array() override { return leave(); }
+
+    bool key(std::string_view name) override {
+        if (depth == 1) {
+            top_key.assign(name);
+        } else if (in_outlets && depth == 2) {
+            domain.assign(name);
+            field.clear();
+        } else if (in_outlets && depth == 3) {
+            field.assign(name);
+        }
+        return true;
+    }
+
+    bool number(double value) override {
+        if (in_outlets && (depth == 2 || (depth == 3 && field == "score"))) {
+            emit(domain, value);
+        }
+        return true;
+    }
+
+private:
+    const std::function<void(std::string_view, double)>& emit;
+    size_t depth = 0;
+    bool in_outlets = false;
+    bool seen_outlets = false;
+    std::string top_key;
+    std::string domain;   // current member of "outlets"
+    std::string field;    // current key inside an object-valued member
+
+    bool leave() {
+        if (depth == 2) {
+            in_outlets = false;
+        }
+        --depth;
+        return true;
+    }
+};
+
+}  // namespace
+
+bool OutletTableBuilder::read_json(const std::string& path,
+                                   const std::function<void(std::string_view, double)>& on_outlet,
+                                   std::string& error) {
+    OutletsHandler handler(on_outlet);
+    JsonReader reader;
+    if (!reader.parse_file(path, handler)) {
+        error = reader.error();
+        return false;
+    }
+    if (!handler.found()) {
+        error = path + ": no \"outlets\" object";
+        return false;
+    }
+    return true;
+}
+
+bool OutletTableBuilder::load_json(const std::string& path) {
+    last_error.clear();
+
+    size_t before = domains.size();
+    auto on_outlet = [this](std::string_view domain, double score) { add(domain, score); };
+    if (!read_json(path, on_outlet, last_error)) {
+        return false;
+    }
+
+    if (domains.size() == before) {
+        last_error = path + ": no outlets found";
+        return false;
+    }
+    return true;
+}
+
+void OutletTableBuilder::add(std::string_view domain, double score) {
+    auto [it, inserted] = index.emplace(std::string(domain), static_cast<uint32_t>(domains.size()));
+    if (inserted) {
+        domains.emplace_back(domain);
+        scores.push_back(score);
+    } else {
+        scores[it->second] = score;  // later entries win, as in a JSON object
+    }
+}
+
+std::vector<uint8_t> OutletTableBuilder::compile() const {
+    const uint32_t n = static_cast<uint32_t>(domains.size());
+
+    std::vector<uint64_t> hashes(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        hashes[i] = hash_bytes(domains[i]);
+    }
+    const VocabularyLayout layout = Vocabulary::layout(hashes);
+    const uint32_t slot_count = layout.slot_count;
+    const uint32_t bucket_count = layout.bucket_count;
+
+    // Section layout
+    OutletImageHeader header{};
+    std::memcpy(header.magic, kOutletImageMagic, sizeof(header.magic));
+    header.version = kOutletImageVersion;
+    header.slot_count = slot_count;
+    header.bucket_count = bucket_count;
+    header.outlet_count = n;
+
+    size_t blob_size = 0;
+    for (const auto& domain : domains) {
+        blob_size += domain.size();
+    }
+
+    size_t offset = align8(sizeof(OutletImageHeader));
+    header.domain_offsets = offset;
+    offset = align8(offset + sizeof(uint32_t) * (static_cast<size_t>(slot_count) + 2));
+    header.domain_blob = offset;
+    offset = align8(offset + blob_size);
+    header.displacements = offset;
+    offset = align8(offset + sizeof(uint32_t) * bucket_count);
+    header.scores = offset;
+    offset = align8(offset + sizeof(double) * (static_cast<size_t>(slot_count) + 1));
+    header.total_size = offset;
+
+    std::vector<uint8_t> image(offset, 0);
+    uint8_t* base = image.data();
+    std::memcpy(base, &header, sizeof(header));
+
+    // Domains and scores in id order; empty slots are zero-length and neutral
+    auto* domain_offsets = reinterpret_cast<uint32_t*>(base + header.domain_offsets);
+    char* domain_blob = reinterpret_cast<char*>(base + header.domain_blob);
+    auto* image_scores = reinterpret_cast<double*>(base + header.scores);
+    uint32_t cursor = 0;
+    domain_offsets[0] = 0;
+    image_scores[0] = 0.0;
+    for (uint32_t id = 1; id <= slot_count; ++id) {
+        domain_offsets[id] = cursor;
+        image_scores[id] = 0.0;
+        uint32_t key = layout.slot_key[id - 1];
+        if (key != 0) {
+            const std::string& domain = domains[key - 1];
+            std::memcpy(domain_blob + cursor, domain.data(), domain.size());
+            cursor += static_cast<uint32_t>(domain.size());
+            image_scores[id] = scores[key - 1];
+        }
+    }
+    domain_offsets[slot_count + 1] = cursor;
+
+    if (bucket_count > 0) {
+        std::memcpy(base + header.displacements, layout.displacements.data(),
+                    sizeof(uint32_t) * bucket_count);
+    }
+
+    return image;
+}
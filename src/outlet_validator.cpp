@@ -1,78 +1,98 @@
 #include "../include/outlet_validator.hpp"
+#include "../include/json_reader.hpp"
+#include "../include/outlet_table_builder.hpp"
 #include <fstream>
-#include <regex>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
 
-OutletValidator::OutletValidator() = default;
+namespace {
 
-bool OutletValidator::load_name_mapping(const std::string& config_path) {
-    std::ifstream file(config_path);
-    if (!file.is_open()) {
-        return false;
+// Collects the string members of the top-level "name_to_domain" object
+class NameMappingHandler final : public JsonHandler {
+public:
+    explicit NameMappingHandler(std::unordered_map<std::string, std::string>& mapping)
+        : name_to_domain(mapping) {}
+
+    bool found() const { return seen_mapping; }
+
+    bool start_object() override {
+        ++depth;
+        if (depth == 2 && top_key == "name_to_domain") {
+            seen_mapping = in_mapping = true;
+        }
+        return true;
     }
 
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
+    bool start_array() override {
+        ++depth;
+        if (depth == 2 && top_key == "name_to_domain") {
+            return stop("\"name_to_domain\" must be an object");
+        }
+        return true;
+    }
 
-    // Find the "name_to_domain" key
-    size_t mapping_pos = content.find("\"name_to_domain\"");
-    if (mapping_pos == std::string::npos) {
-        return false;
+    bool end_object() override { return leave(); }
+    bool end_array() override { return leave(); }
+
+    bool key(std::string_view name) override {
+        if (depth == 1) {
+            top_key.assign(name);
+        } else if (in_mapping && depth == 2) {
+            outlet_name.assign(name);
+        }
+        return true;
     }
 
-    // Find the opening brace after "name_to_domain"
-    size_t open_brace = content.find("{", mapping_pos);
-    if (open_brace == std::string::npos) {
-        return false;
+    bool string(std::string_view domain) override {
+        if (in_mapping && depth == 2) {
+            name_to_domain[outlet_name] = std::string(domain);
+        }
+        return true;
     }
 
-    // Find matching closing brace
-    int brace_count = 1;
-    size_t close_brace = open_brace + 1;
-    while (close_brace < content.length() && brace_count > 0) {
-        if (content[close_brace] == '{') {
-            brace_count++;
-        } else if (content[close_brace] == '}') {
-            brace_count--;
+private:
+    std::unordered_map<std::string, std::string>& name_to_domain;
+    size_t depth = 0;
+    bool in_mapping = false;
+    bool seen_mapping = false;
+    std::string top_key;
+    std::string outlet_name;
+
+    bool leave() {
+        if (depth == 2) {
+            in_mapping = false;
         }
-        close_brace++;
+        --depth;
+        return true;
     }
+};
 
-    // Extract mapping object
-    std::string mapping_str = content.substr(open_brace + 1, close_brace - open_brace - 2);
+}  // namespace
 
-    // Parse key-value pairs: "name": "domain"
-    std::regex pair_regex("\"([^\"]+)\"\\s*:\\s*\"([^\"]+)\"");
-    std::smatch match;
-    std::string::const_iterator search_start(mapping_str.cbegin());
+OutletValidator::OutletValidator() = default;
 
-    while (std::regex_search(search_start, mapping_str.cend(), match, pair_regex)) {
-        std::string name = match[1].str();
-        std::string domain = match[2].str();
-        name_to_domain[name] = domain;
+bool OutletValidator::load_name_mapping(const std::string& config_path) {
+    last_error.clear();
 
-        search_start = match.suffix().first;
+    NameMappingHandler handler(name_to_domain);
+    JsonReader reader;
+    if (!reader.parse_file(config_path, handler)) {
+        last_error = reader.error();
+        return false;
+    }
+    if (!handler.found()) {
+        last_error = config_path + ": no \"name_to_domain\" object";
+        return false;
     }
 
     return !name_to_domain.empty();
 }
 
 bool OutletValidator::load_allsides(const std::string& config_path) {
-    std::ifstream file(config_path);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
-
     // First parse the outlets
-    if (!parse_outlets_json(content, allsides_outlets)) {
+    if (!parse_outlets_json(config_path, allsides_outlets)) {
         return false;
     }
 
@@ -92,64 +112,21 @@ bool OutletValidator::load_allsides(const std::string& config_path) {
 }
 
 bool OutletValidator::load_mbfc(const std::string& config_path) {
-    std::ifstream file(config_path);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
-
-    return parse_outlets_json(content, mbfc_outlets);
+    return parse_outlets_json(config_path, mbfc_outlets);
 }
 
-bool OutletValidator::parse_outlets_json(const std::string& content,
+bool OutletValidator::parse_outlets_json(const std::string& config_path,
                                         std::unordered_map<std::string, double>& outlets) {
-    // Find the "outlets" key
-    size_t outlets_pos = content.find("\"outlets\"");
-    if (outlets_pos == std::string::npos) {
-        return false;
-    }
+    last_error.clear();
 
-    // Find the opening brace after "outlets"
-    size_t open_brace = content.find("{", outlets_pos);
-    if (open_brace == std::string::npos) {
+    // "domain": score or "domain": {"score": ..., ...}; later entries win
+    auto on_outlet = [&outlets](std::string_view outlet_name, double score) {
+        outlets[std::string(outlet_name)] = score;
+    };
+    if (!OutletTableBuilder::read_json(config_path, on_outlet, last_error)) {
         return false;
     }
 
-    // Find matching closing brace
-    int brace_count = 1;
-    size_t close_brace = open_brace + 1;
-    while (close_brace < content.length() && brace_count > 0) {
-        if (content[close_brace] == '{') {
-            brace_count++;
-        } else if (content[close_brace] == '}') {
-            brace_count--;
-        }
-        close_brace++;
-    }
-
-    // Extract outlets object
-    std::string outlets_str = content.substr(open_brace + 1, close_brace - open_brace - 2);
-
-    // Parse key-value pairs: "domain": score or "domain": {score: ..., ...}
-    std::regex pair_regex("\"([^\"]+)\"\\s*:\\s*([+-]?[0-9]*\\.?[0-9]+)");
-    std::smatch match;
-    std::string::const_iterator search_start(outlets_str.cbegin());
-
-    while (std::regex_search(search_start, outlets_str.cend(), match, pair_regex)) {
-        std::string outlet_name = match[1].str();
-        double score = std::stod(match[2].str());
-        
-        // Only add if not already added (in case of nested objects)
-        if (outlets.find(outlet_name) == outlets.end()) {
-            outlets[outlet_name] = score;
-        }
-
-        search_start = match.suffix().first;
-    }
-
     return !outlets.empty();
 }
 
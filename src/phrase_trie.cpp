@@ -0,0 +1,24 @@
+#include "../include/phrase_trie.hpp"
+
+std::vector<PhraseEdge> PhraseTrie::layout(const std::vector<PhraseEdge>& edges) {
+    if (edges.empty()) {
+        return {};
+    }
+
+    // Power of two, at most half full, so probes stay short
+    uint32_t slot_count = 2;
+    while (slot_count < 2 * edges.size()) {
+        slot_count *= 2;
+    }
+    const uint32_t mask = slot_count - 1;
+
+    std::vector<PhraseEdge> table(slot_count, PhraseEdge{});
+    for (const PhraseEdge& edge : edges) {
+        uint32_t i = slot_of(edge.from, edge.token, mask);
+        while (table[i].to != 0) {
+            i = (i + 1) & mask;
+        }
+        table[i] = edge;
+    }
+    return table;
+}
@@ -1,20 +1,82 @@
 #include "../include/preprocessor.hpp"
-#include <sstream>
+#include "../include/sentence_splitter.hpp"
+#include "../include/lexicon.hpp"
+#include "../include/hash.hpp"
+#include "../include/word_embeddings.hpp"
 #include <algorithm>
-#include <cctype>
-#include <regex>
 
-NLPContext Preprocessor::process(const ArticleInput& article) {
+namespace {
+
+// ASCII classification matching the "C" locale behaviour of <cctype>,
+// without the locale lookup or the UB on negative chars
+inline bool is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_alnum(unsigned char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+inline char to_lower(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : static_cast<char>(c);
+}
+
+// Whitespace-delimited words that keep at least one alphanumeric byte after
+// punctuation trimming, i.e. exactly what tokenize() emits; stops at limit
+size_t count_words(std::string_view text, size_t limit) {
+    size_t count = 0;
+    const size_t n = text.size();
+    size_t i = 0;
+    while (i < n && count < limit) {
+        while (i < n && is_space(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        bool has_alnum = false;
+        while (i < n && !is_space(static_cast<unsigned char>(text[i]))) {
+            has_alnum = has_alnum || is_alnum(static_cast<unsigned char>(text[i]));
+            ++i;
+        }
+        count += has_alnum;
+    }
+    return count;
+}
+
+// title + " " + body as tokenize() lays it out, without copying
+struct JoinedText {
+    std::string_view head;
+    std::string_view tail;
+
+    size_t size() const { return head.size() + 1 + tail.size(); }
+    char operator[](size_t i) const {
+        if (i < head.size()) return head[i];
+        if (i == head.size()) return ' ';
+        return tail[i - head.size() - 1];
+    }
+};
+
+}  // namespace
+
+NLPContext Preprocessor::process(const ArticleInput& article) const {
     NLPContext ctx;
+    process(article, ctx);
+    return ctx;
+}
+
+void Preprocessor::process(const ArticleInput& article, NLPContext& ctx) const {
+    ctx.reset();
 
-    // Combine title and body for full text analysis
-    std::string full_text = article.title + " " + article.body;
+    // Every stage below reads this one lexicon (and word vector) version
+    ctx.lexicon = Lexicon::current(ctx.lexicon_version);
+    ctx.embeddings = WordEmbeddings::current(ctx.embeddings_version);
 
-    // Tokenize
-    ctx.tokens = tokenize(full_text);
+    // Tokenize (also builds the lowercased full text in ctx.text)
+    tokenize(ctx, article);
 
     // Split into sentences
-    ctx.sentences = split_sentences(article.body);
+    split_sentences(ctx, article);
+
+    // Lexical features for all downstream stages
+    tag_tokens(ctx);
 
     // Extract entities (stub - can be extended with NER model)
     extract_entities(ctx, article);
@@ -25,166 +87,159 @@ NLPContext Preprocessor::process(const ArticleInput& article) {
     // Compute emotion
     compute_emotion(ctx);
 
-    return ctx;
+    // Document embedding for the vector-space signals
+    embed(ctx);
 }
 
-std::vector<std::string> Preprocessor::tokenize(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::istringstream stream(text);
-    std::string word;
+size_t Preprocessor::count_tokens(const ArticleInput& article, size_t limit) const {
+    // The title and body are joined by a space, so no word spans the two
+    size_t count = count_words(article.title, limit);
+    if (count < limit) {
+        count += count_words(article.body, limit - count);
+    }
+    return count;
+}
 
-    while (stream >> word) {
-        // Remove punctuation from word ends
-        while (!word.empty() && !std::isalnum(word.back())) {
-            word.pop_back();
+bool Preprocessor::has_entities(const ArticleInput& article) const {
+    return Lexicon::current()->entity_matcher().contains_any(
+        JoinedText{article.title, article.body});
+}
+
+void Preprocessor::tokenize(NLPContext& ctx, const ArticleInput& article) const {
+    // Combine title and body for full text analysis, lowercased once
+    std::string& text = ctx.text;
+    text.clear();
+    text.reserve(article.title.size() + 1 + article.body.size());
+    text.append(article.title);
+    text.push_back(' ');
+    text.append(article.body);
+    for (char& c : text) {
+        c = to_lower(static_cast<unsigned char>(c));
+    }
+
+    const Vocabulary& vocabulary = ctx.lexicon->vocabulary();
+
+    ctx.tokens.clear();
+    ctx.token_ids.clear();
+    ctx.token_hashes.clear();
+    ctx.tokens.reserve(text.size() / 6);  // ~average English word + space
+    ctx.token_ids.reserve(text.size() / 6);
+    ctx.token_hashes.reserve(text.size() / 6);
+
+    const size_t n = text.size();
+    size_t i = 0;
+    while (i < n) {
+        while (i < n && is_space(static_cast<unsigned char>(text[i]))) {
+            ++i;
         }
-        while (!word.empty() && !std::isalnum(word.front())) {
-            word = word.substr(1);
+        size_t begin = i;
+        while (i < n && !is_space(static_cast<unsigned char>(text[i]))) {
+            ++i;
         }
+        size_t end = i;
 
-        if (!word.empty()) {
-            // Lowercase
-            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-            tokens.push_back(word);
+        // Remove punctuation from word ends
+        while (begin < end && !is_alnum(static_cast<unsigned char>(text[begin]))) {
+            ++begin;
+        }
+        while (end > begin && !is_alnum(static_cast<unsigned char>(text[end - 1]))) {
+            --end;
         }
-    }
-
-    return tokens;
-}
 
-std::vector<std::string> Preprocessor::split_sentences(const std::string& text) {
-    std::vector<std::string> sentences;
-    std::regex sentence_regex(R"([^.!?]+[.!?]+)");
-    
-    auto begin = std::sregex_iterator(text.begin(), text.end(), sentence_regex);
-    auto end = std::sregex_iterator();
-
-    for (auto it = begin; it != end; ++it) {
-        std::string sentence = it->str();
-        // Trim whitespace
-        sentence.erase(0, sentence.find_first_not_of(" \t\n\r"));
-        sentence.erase(sentence.find_last_not_of(" \t\n\r") + 1);
-        if (!sentence.empty()) {
-            sentences.push_back(sentence);
+        if (end > begin) {
+            std::string_view word(text.data() + begin, end - begin);
+            uint64_t hash = hash_bytes(word);
+            ctx.tokens.push_back(TextSpan{static_cast<uint32_t>(begin),
+                                          static_cast<uint32_t>(end - begin)});
+            ctx.token_ids.push_back(vocabulary.find(word, hash));
+            ctx.token_hashes.push_back(hash);
         }
     }
+}
 
-    return sentences;
+void Preprocessor::split_sentences(NLPContext& ctx, const ArticleInput& article) const {
+    // Body starts right after "title " in ctx.text; lowercasing keeps byte
+    // offsets, so spans found on the original body address ctx.text directly
+    ctx.sentences.clear();
+    SentenceSplitter::split(article.body,
+                            static_cast<uint32_t>(article.title.size() + 1),
+                            ctx.sentences);
 }
 
-void Preprocessor::extract_entities(NLPContext& ctx, const ArticleInput& article) {
+void Preprocessor::extract_entities(NLPContext& ctx, const ArticleInput& /*article*/) const {
     // Stub: In production, use spaCy via Python bindings or a C++ NER model
     // For now, we extract simple heuristics based on common political entities
 
-    std::vector<std::pair<std::string, std::string>> known_entities = {
-        // Left-leaning
-        {"biden", "left"},
-        {"democrats", "left"},
-        {"democratic", "left"},
-        {"harris", "left"},
-        {"obama", "left"},
-        {"pelosi", "left"},
-        {"schumer", "left"},
-        {"progressive", "left"},
-        {"climate", "left"},
-        {"regulation", "left"},
-        
-        // Right-leaning
-        {"trump", "right"},
-        {"republicans", "right"},
-        {"republican", "right"},
-        {"mcconnell", "right"},
-        {"desantis", "right"},
-        {"pence", "right"},
-        {"cpac", "right"},
-        {"conservative", "right"},
-        {"freedom", "right"},
-        {"market", "right"},
-        
-        // Neutral
-        {"congress", "neutral"},
-        {"senate", "neutral"},
-        {"house", "neutral"},
-        {"bill", "neutral"},
-    };
-
-    std::string full_text = article.title + " " + article.body;
-    std::transform(full_text.begin(), full_text.end(), full_text.begin(), ::tolower);
-
-    for (const auto& [entity_name, ideology] : known_entities) {
-        if (full_text.find(entity_name) != std::string::npos) {
-            EntityMention mention{
-                .name = entity_name,
-                .ideology = ideology,
-                .sentiment = 0.0,  // Will be updated in compute_sentiment
-                .emotion = 0.0     // Will be updated in compute_emotion
-            };
-            ctx.add_entity(mention);
-        }
+    const Lexicon& lexicon = *ctx.lexicon;
+    const EntityMatcher& matcher = lexicon.entity_matcher();
+
+    ctx.entities.clear();
+
+    matcher.scan(ctx.text, [&](const EntityMatcher::Match& match) {
+        ctx.entities.add_mention(match.pattern, lexicon.entity_ideology(match.pattern),
+                                 TextSpan{match.offset, match.length});
+    });
+}
+
+void Preprocessor::tag_tokens(NLPContext& ctx) const {
+    // Token ids were resolved during tokenization; every lookup here is a
+    // dense array index (id 0 = unknown word = all-zero entry)
+    const Lexicon& lexicon = *ctx.lexicon;
+    const size_t n = ctx.token_count();
+    const uint32_t* ids = ctx.token_ids.data();
+    TokenFeatures& features = ctx.features;
+    features.reset(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const LexiconEntry& entry = lexicon.entry(ids[i]);
+        features.sentiment[i] = entry.sentiment;
+        features.emotion[i] = entry.emotion;
+        features.frame_direction[i] = entry.frame_direction;
+        features.frame_weight[i] = entry.frame_weight;
+        features.context[i] = entry.context;
+        features.semantic_dimension[i] = entry.semantic_dimension;
+        features.semantic_weight[i] = entry.semantic_weight;
     }
 }
 
-void Preprocessor::compute_sentiment(NLPContext& ctx) {
-    // Stub sentiment analysis
-    // In production: use VADER, TextBlob, or fine-tuned model
-    
-    std::vector<std::pair<std::string, double>> sentiment_words = {
-        // Positive
-        {"great", 0.5},
-        {"excellent", 0.6},
-        {"good", 0.4},
-        {"wonderful", 0.6},
-        {"strong", 0.3},
-        
-        // Negative
-        {"bad", -0.4},
-        {"terrible", -0.6},
-        {"awful", -0.6},
-        {"poor", -0.4},
-        {"weak", -0.3},
-        {"corrupt", -0.7},
-        {"failed", -0.5},
-    };
-
-    for (auto& entity : ctx.entities) {
-        double total_sentiment = 0.0;
-        int count = 0;
-
-        for (const auto& token : ctx.tokens) {
-            for (const auto& [word, sentiment] : sentiment_words) {
-                if (token == word) {
-                    total_sentiment += sentiment;
-                    count++;
-                }
-            }
+void Preprocessor::compute_sentiment(NLPContext& ctx) const {
+    // Stub sentiment analysis: average polarity of all sentiment words,
+    // attributed to every entity. In production: VADER, TextBlob, or fine-tuned model
+    const std::vector<float>& sentiment = ctx.features.sentiment;
+
+    double total_sentiment = 0.0;
+    int count = 0;
+    for (float value : sentiment) {
+        if (value != 0.0f) {
+            total_sentiment += value;
+            count++;
         }
+    }
 
-        if (count > 0) {
-            entity.sentiment = total_sentiment / count;
-            ctx.cache_sentiment(entity.name, entity.sentiment);
-        }
+    if (count == 0) {
+        return;
     }
+
+    std::fill(ctx.entities.sentiment.begin(), ctx.entities.sentiment.end(),
+              static_cast<float>(total_sentiment / count));
 }
 
-void Preprocessor::compute_emotion(NLPContext& ctx) {
+void Preprocessor::compute_emotion(NLPContext& ctx) const {
     // Stub emotion computation
     // In production: use emotion detection model (NRC, etc.)
-    
-    std::vector<std::string> emotional_words = {
-        "angry", "furious", "outraged",
-        "shocking", "devastating", "alarming",
-        "beautiful", "inspiring", "wonderful"
-    };
-
-    for (auto& entity : ctx.entities) {
-        double emotion_score = 0.0;
-        for (const auto& token : ctx.tokens) {
-            for (const auto& emotion_word : emotional_words) {
-                if (token == emotion_word) {
-                    emotion_score += 0.3;
-                }
-            }
-        }
-        entity.emotion = std::min(emotion_score, 1.0);
+    double emotion_score = 0.0;
+    for (float value : ctx.features.emotion) {
+        emotion_score += value;
+    }
+
+    std::fill(ctx.entities.emotion.begin(), ctx.entities.emotion.end(),
+              static_cast<float>(std::min(emotion_score, 1.0)));
+}
+
+void Preprocessor::embed(NLPContext& ctx) const {
+    const WordEmbeddings& embeddings = *ctx.embeddings;
+    if (!embeddings.empty()) {
+        ctx.embedding.resize(embeddings.dimension());
+        embeddings.embed(ctx, ctx.embedding.data());
     }
 }
@@ -0,0 +1,103 @@
+#include "../include/result_cache.hpp"
+#include "../include/hash.hpp"
+
+ResultCache::ResultCache(size_t capacity, size_t shard_count) {
+    size_t count = 1;
+    uint32_t bits = 0;
+    while (count < shard_count && count * 2 <= capacity) {
+        count <<= 1;
+        ++bits;
+    }
+    shard_shift = 64 - bits;
+
+    shards.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto shard = std::make_unique<Shard>();
+        // Spread the remainder so the shard capacities add up to capacity
+        shard->capacity = capacity / count + (i < capacity % count ? 1 : 0);
+        shard->index.reserve(shard->capacity);
+        shards.push_back(std::move(shard));
+    }
+}
+
+namespace {
+
+// Seed of the verification hash; any constant unrelated to the key's works
+constexpr uint64_t kCheckSeed = 0xC2B2AE3D27D4EB4FULL;
+
+}  // namespace
+
+ResultCache::Key ResultCache::key_for(const ArticleInput& article, uint64_t generation) {
+    // Analysis runs on lowercase(title + " " + body), so case variants share
+    // an entry; hashing the two parts separately avoids building the string
+    Key key;
+    key.hash = hash_bytes_folded(article.body, hash_bytes_folded(article.title, generation));
+    key.check = hash_bytes_folded(article.body,
+                                  hash_bytes_folded(article.title, generation ^ kCheckSeed));
+    return key;
+}
+
+bool ResultCache::lookup(const Key& key, Entry& out) {
+    Shard& shard = shard_for(key.hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key.hash);
+    if (it == shard.index.end() || it->second->key.check != key.check) {
+        ++shard.misses;
+        return false;
+    }
+
+    ++shard.hits;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    out = it->second->entry;
+    return true;
+}
+
+void ResultCache::insert(const Key& key, Entry entry) {
+    Shard& shard = shard_for(key.hash);
+    if (shard.capacity == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key.hash);
+    if (it != shard.index.end()) {
+        // Another thread analyzed the same text meanwhile (or, on a hash
+        // collision, another text); keep the newer one
+        it->second->key = key;
+        it->second->entry = std::move(entry);
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    if (shard.lru.size() >= shard.capacity) {
+        shard.index.erase(shard.lru.back().key.hash);
+        shard.lru.pop_back();
+        ++shard.evictions;
+    }
+
+    shard.lru.push_front(Node{key, std::move(entry)});
+    shard.index.emplace(key.hash, shard.lru.begin());
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    Stats total;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total.hits += shard->hits;
+        total.misses += shard->misses;
+        total.evictions += shard->evictions;
+        total.size += shard->lru.size();
+        total.capacity += shard->capacity;
+    }
+    return total;
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+    }
+}
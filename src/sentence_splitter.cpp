@@ -0,0 +1,171 @@
+#include "../include/sentence_splitter.hpp"
+
+namespace {
+
+inline bool is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_digit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool is_upper(unsigned char c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+inline bool is_alpha(unsigned char c) {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+}
+
+inline bool is_terminator(unsigned char c) {
+    return c == '.' || c == '!' || c == '?';
+}
+
+// Abbreviations that normally do not end a sentence (lowercase, no final '.')
+constexpr std::string_view kAbbreviations[] = {
+    "mr", "mrs", "ms", "dr", "prof", "sr", "jr", "st", "mt", "ft",
+    "sen", "rep", "gov", "gen", "col", "lt", "sgt", "capt", "cmdr", "adm",
+    "pres", "rev", "hon", "atty", "supt", "dept", "univ", "assn", "bros",
+    "inc", "ltd", "co", "corp", "llc", "no", "vs", "etc", "approx", "est",
+    "jan", "feb", "mar", "apr", "jun", "jul", "aug", "sep", "sept", "oct",
+    "nov", "dec", "e.g", "i.e", "u.s", "u.k", "u.n", "d.c", "a.m", "p.m",
+};
+constexpr size_t kMaxAbbreviationLength = 6;
+
+bool equals_lowercase(std::string_view word, std::string_view lower) {
+    if (word.size() != lower.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < word.size(); ++i) {
+        if ((static_cast<unsigned char>(word[i]) | 0x20) != static_cast<unsigned char>(lower[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Is the word ending right before text[dot] an abbreviation or an initial?
+bool is_abbreviation(std::string_view text, size_t dot) {
+    size_t begin = dot;
+    while (begin > 0 && !is_space(static_cast<unsigned char>(text[begin - 1])) &&
+           dot - begin <= kMaxAbbreviationLength) {
+        --begin;
+    }
+    // Skip opening quotes/brackets glued to the word
+    while (begin < dot && !is_alpha(static_cast<unsigned char>(text[begin]))) {
+        ++begin;
+    }
+    std::string_view word = text.substr(begin, dot - begin);
+    if (word.empty() || word.size() > kMaxAbbreviationLength) {
+        return false;
+    }
+
+    // Single-letter initial: "J. Smith"
+    if (word.size() == 1 && is_alpha(static_cast<unsigned char>(word[0]))) {
+        return true;
+    }
+
+    for (std::string_view abbreviation : kAbbreviations) {
+        if (equals_lowercase(word, abbreviation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Closing quote/bracket at text[i]; returns its byte length or 0
+size_t closer_length(std::string_view text, size_t i) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c == '"' || c == '\'' || c == ')' || c == ']') {
+        return 1;
+    }
+    // UTF-8 right single/double quotation marks: E2 80 99 / E2 80 9D
+    if (c == 0xE2 && i + 2 < text.size() &&
+        static_cast<unsigned char>(text[i + 1]) == 0x80 &&
+        (static_cast<unsigned char>(text[i + 2]) == 0x99 ||
+         static_cast<unsigned char>(text[i + 2]) == 0x9D)) {
+        return 3;
+    }
+    return 0;
+}
+
+// Does the next word (starting at i, after whitespace) look like a sentence start?
+bool starts_sentence(std::string_view text, size_t i) {
+    if (i >= text.size()) {
+        return true;
+    }
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    return is_upper(c) || is_digit(c) || c == '"' || c == '\'' || c == '(' || c == 0xE2;
+}
+
+}  // namespace
+
+void SentenceSplitter::split(std::string_view text, uint32_t base_offset,
+                             std::vector<TextSpan>& out) {
+    const size_t n = text.size();
+    size_t start = 0;
+    size_t i = 0;
+
+    auto emit = [&](size_t begin, size_t end) {
+        while (begin < end && is_space(static_cast<unsigned char>(text[begin]))) {
+            ++begin;
+        }
+        while (end > begin && is_space(static_cast<unsigned char>(text[end - 1]))) {
+            --end;
+        }
+        if (end > begin) {
+            out.push_back(TextSpan{static_cast<uint32_t>(base_offset + begin),
+                                   static_cast<uint32_t>(end - begin)});
+        }
+    };
+
+    while (i < n) {
+        if (!is_terminator(static_cast<unsigned char>(text[i]))) {
+            ++i;
+            continue;
+        }
+
+        // Consume the whole terminator run ("?!", "...")
+        size_t run_begin = i;
+        size_t dots = 0;
+        while (i < n && is_terminator(static_cast<unsigned char>(text[i]))) {
+            dots += (text[i] == '.');
+            ++i;
+        }
+        size_t run_length = i - run_begin;
+
+        // Closing quotes/brackets belong to the sentence being ended
+        size_t closer;
+        while (i < n && (closer = closer_length(text, i)) > 0) {
+            i += closer;
+        }
+
+        // Must be followed by whitespace or end of text ("3.5", "cnn.com")
+        if (i < n && !is_space(static_cast<unsigned char>(text[i]))) {
+            continue;
+        }
+
+        size_t next = i;
+        while (next < n && is_space(static_cast<unsigned char>(text[next]))) {
+            ++next;
+        }
+
+        if (run_length == 1 && dots == 1) {
+            if (is_abbreviation(text, run_begin) && !(next < n && text[next] == '\n')) {
+                continue;
+            }
+        } else if (dots == run_length && run_length >= 2) {
+            // Ellipsis: only a boundary when a new sentence visibly starts
+            if (!starts_sentence(text, next)) {
+                continue;
+            }
+        }
+
+        emit(start, i);
+        start = next;
+        i = next;
+    }
+
+    emit(start, n);
+}
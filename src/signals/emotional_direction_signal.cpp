@@ -1,38 +1,32 @@
 #include "../../include/signals/emotional_direction_signal.hpp"
 #include <sstream>
 
-double EmotionalDirectionSignal::compute(const NLPContext& ctx,
-                                          const ArticleInput& article) {
-    double left_emotion_sum = 0.0;
-    double right_emotion_sum = 0.0;
-    int left_count = 0;
-    int right_count = 0;
+SignalOutput EmotionalDirectionSignal::compute(const NLPContext& ctx,
+                                                const ArticleInput& /*article*/) const {
+    // Weight emotion by sentiment: if entity is spoken of negatively,
+    // and it has high emotion, that's a bias signal against that entity
+    const float* emotion = ctx.entities.emotion.data();
+    const float* sentiment = ctx.entities.sentiment.data();
+    IdeologyTotals totals = ctx.entities.totals_by_ideology(
+        [emotion, sentiment](size_t e) { return emotion[e] * -sentiment[e]; });
 
-    for (const auto& entity : ctx.entities) {
-        // Weight emotion by sentiment: if entity is spoken of negatively,
-        // and it has high emotion, that's a bias signal against that entity
-        double weighted_emotion = entity.emotion * (-entity.sentiment);
-
-        if (entity.ideology == "left") {
-            left_emotion_sum += weighted_emotion;
-            left_count++;
-        } else if (entity.ideology == "right") {
-            right_emotion_sum += weighted_emotion;
-            right_count++;
-        }
-    }
-
-    left_emotion = (left_count > 0) ? left_emotion_sum / left_count : 0.0;
-    right_emotion = (right_count > 0) ? right_emotion_sum / right_count : 0.0;
+    double left_emotion = (totals.left_count > 0) ? totals.left / totals.left_count : 0.0;
+    double right_emotion = (totals.right_count > 0) ? totals.right / totals.right_count : 0.0;
 
     // Diff: if left entities have more emotional negativity, it's a right bias
     double diff = left_emotion - right_emotion;
 
     // Clamp to [-1, 1]
-    return std::max(-1.0, std::min(1.0, diff));
+    return SignalOutput{
+        .score = std::max(-1.0, std::min(1.0, diff)),
+        .left = left_emotion,
+        .right = right_emotion
+    };
 }
 
-std::string EmotionalDirectionSignal::explain() const {
+std::string EmotionalDirectionSignal::explain(const SignalOutput& output) const {
+    const double left_emotion = output.left;
+    const double right_emotion = output.right;
     std::ostringstream oss;
     oss << "Emotional direction: left entity emotions=" << left_emotion
         << ", right entity emotions=" << right_emotion;
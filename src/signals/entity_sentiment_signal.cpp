@@ -1,35 +1,30 @@
 #include "../../include/signals/entity_sentiment_signal.hpp"
 #include <sstream>
 
-double EntitySentimentSignal::compute(const NLPContext& ctx,
-                                       const ArticleInput& article) {
-    double left_sentiment_sum = 0.0;
-    double right_sentiment_sum = 0.0;
-    int left_count = 0;
-    int right_count = 0;
+SignalOutput EntitySentimentSignal::compute(const NLPContext& ctx,
+                                             const ArticleInput& /*article*/) const {
+    const float* sentiment = ctx.entities.sentiment.data();
+    IdeologyTotals totals = ctx.entities.totals_by_ideology(
+        [sentiment](size_t e) { return sentiment[e]; });
 
-    for (const auto& entity : ctx.entities) {
-        if (entity.ideology == "left") {
-            left_sentiment_sum += entity.sentiment;
-            left_count++;
-        } else if (entity.ideology == "right") {
-            right_sentiment_sum += entity.sentiment;
-            right_count++;
-        }
-    }
-
-    left_avg = (left_count > 0) ? left_sentiment_sum / left_count : 0.0;
-    right_avg = (right_count > 0) ? right_sentiment_sum / right_count : 0.0;
+    double left_avg = (totals.left_count > 0) ? totals.left / totals.left_count : 0.0;
+    double right_avg = (totals.right_count > 0) ? totals.right / totals.right_count : 0.0;
 
     // If left entities have negative sentiment and right have positive, it's left bias
     // If right entities have negative sentiment and left have positive, it's right bias
     double diff = left_avg - right_avg;
 
     // Clamp to [-1, 1]
-    return std::max(-1.0, std::min(1.0, diff));
+    return SignalOutput{
+        .score = std::max(-1.0, std::min(1.0, diff)),
+        .left = left_avg,
+        .right = right_avg
+    };
 }
 
-std::string EntitySentimentSignal::explain() const {
+std::string EntitySentimentSignal::explain(const SignalOutput& output) const {
+    const double left_avg = output.left;
+    const double right_avg = output.right;
     std::ostringstream oss;
     oss << "Entity sentiment: left entities avg=" << left_avg
         << ", right entities avg=" << right_avg;
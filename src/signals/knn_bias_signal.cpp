@@ -0,0 +1,54 @@
+#include "../../include/signals/knn_bias_signal.hpp"
+#include "../../include/knn_index.hpp"
+#include "../../include/word_embeddings.hpp"
+#include <algorithm>
+#include <sstream>
+
+SignalOutput KnnBiasSignal::compute(const NLPContext& ctx, const ArticleInput& /*article*/) const {
+    // Pinned for this call, so a concurrent reload cannot free it under us
+    std::shared_ptr<const KnnIndex> index = KnnIndex::current();
+
+    // The query is the Preprocessor's word-vector embedding, which is only
+    // comparable if it comes from the model the index was built with; a
+    // text without known words embeds to zero and finds nothing
+    if (index->empty() || ctx.embedding.size() != index->dimension() ||
+        ctx.embeddings->fingerprint() != index->embeddings_fingerprint()) {
+        return SignalOutput{.abstained = true};
+    }
+
+    KnnNeighbor neighbors[kNeighbors];
+    const size_t found = index->search(ctx.embedding.data(), kNeighbors, neighbors);
+
+    // Similarity-weighted mean rating, split into its leftward and rightward
+    // parts so left/right carry evidence like every other signal's
+    double left_sum = 0.0;
+    double right_sum = 0.0;
+    double weight_sum = 0.0;
+    for (size_t i = 0; i < found; ++i) {
+        const double weight = std::max(0.0f, neighbors[i].similarity);
+        const double rating = index->rating(neighbors[i].id);
+        left_sum += weight * std::max(0.0, -rating);
+        right_sum += weight * std::max(0.0, rating);
+        weight_sum += weight;
+    }
+    if (weight_sum <= 0.0) {
+        return SignalOutput{.abstained = true};
+    }
+
+    const double left = left_sum / weight_sum;
+    const double right = right_sum / weight_sum;
+    double score = std::max(-1.0, std::min(1.0, right - left));
+    return SignalOutput{.score = score, .left = left, .right = right};
+}
+
+std::string KnnBiasSignal::explain(const SignalOutput& output) const {
+    if (output.abstained) {
+        return "kNN bias: abstained (no labeled index for the loaded word vectors, or no similar rated article)";
+    }
+    std::ostringstream oss;
+    oss << "kNN bias: nearest rated articles lean left=" << output.left
+        << ", right=" << output.right
+        << " → rated " << (output.score > 0 ? "right" : output.score < 0 ? "left" : "center")
+        << " on average";
+    return oss.str();
+}
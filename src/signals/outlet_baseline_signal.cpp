@@ -1,67 +1,31 @@
 #include "../../include/signals/outlet_baseline_signal.hpp"
+#include "../../include/outlet_table_builder.hpp"
 #include <sstream>
-#include <fstream>
-#include <regex>
 
-OutletBaselineSignal::OutletBaselineSignal() {
-    load_from_json("config/outlets.json");
-}
+OutletBaselineSignal::OutletBaselineSignal() = default;
 
 bool OutletBaselineSignal::load_from_json(const std::string& config_path) {
-    std::ifstream file(config_path);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    file.close();
-
-    size_t outlets_pos = content.find("\"outlets\"");
-    if (outlets_pos == std::string::npos) {
+    OutletTableBuilder builder;
+    auto table = std::make_shared<OutletTable>();
+    if (!builder.load_json(config_path) || !table->load_image(builder.compile())) {
         return false;
     }
-
-    size_t open_brace = content.find("{", outlets_pos);
-    if (open_brace == std::string::npos) {
-        return false;
-    }
-
-    int brace_count = 1;
-    size_t close_brace = open_brace + 1;
-    while (close_brace < content.length() && brace_count > 0) {
-        if (content[close_brace] == '{') {
-            brace_count++;
-        } else if (content[close_brace] == '}') {
-            brace_count--;
-        }
-        close_brace++;
-    }
-
-    std::string outlets_str = content.substr(open_brace + 1, close_brace - open_brace - 2);
-
-    std::regex pair_regex("\"([^\"]+)\"\\s*:\\s*([+-]?[0-9]*\\.?[0-9]+)");
-    std::smatch match;
-    std::string::const_iterator search_start(outlets_str.cbegin());
-
-    while (std::regex_search(search_start, outlets_str.cend(), match, pair_regex)) {
-        std::string domain = match[1].str();
-        double score = std::stod(match[2].str());
-        outlet_scores[domain] = score;
-
-        search_start = match.suffix().first;
-    }
-
-    return !outlet_scores.empty();
+    own_outlets = std::move(table);
+    return true;
 }
 
-double OutletBaselineSignal::compute(const NLPContext& ctx,
-                                      const ArticleInput& article) {
-    last_score = get_outlet_score(article.domain);
-    return last_score;
+SignalOutput OutletBaselineSignal::compute(const NLPContext& /*ctx*/,
+                                            const ArticleInput& article) const {
+    if (own_outlets) {
+        return SignalOutput{.score = get_outlet_score(*own_outlets, article)};
+    }
+    // Pinned for this call, so a concurrent reload cannot free it under us
+    std::shared_ptr<const OutletTable> outlets = OutletTable::current();
+    return SignalOutput{.score = get_outlet_score(*outlets, article)};
 }
 
-std::string OutletBaselineSignal::explain() const {
+std::string OutletBaselineSignal::explain(const SignalOutput& output) const {
+    const double last_score = output.score;
     std::ostringstream oss;
     oss << "Outlet baseline bias: " << last_score;
     if (last_score > 0.5) {
@@ -78,11 +42,12 @@ std::string OutletBaselineSignal::explain() const {
     return oss.str();
 }
 
-double OutletBaselineSignal::get_outlet_score(const std::string& domain) const {
-    auto it = outlet_scores.find(domain);
-    if (it != outlet_scores.end()) {
-        return it->second;
+double OutletBaselineSignal::get_outlet_score(const OutletTable& outlets,
+                                              const ArticleInput& article) const {
+    uint32_t id = outlets.resolve(article.domain);
+    if (id == Vocabulary::kUnknown && !article.url.empty()) {
+        id = outlets.resolve(article.url);
     }
-    // Default unknown outlets to neutral
-    return 0.0;
+    // Unknown outlets default to neutral
+    return outlets.score(id);
 }
@@ -1,116 +1,59 @@
 #include "../../include/signals/policy_framing_signal.hpp"
+#include "../../include/lexicon.hpp"
 #include <sstream>
 #include <algorithm>
-#include <map>
-#include <cmath>
 
-double PolicyFramingSignal::compute(const NLPContext& ctx,
-                                     const ArticleInput& article) {
-    // Define framing terms with directionality
-    // These are high-conviction bias indicators
-    std::map<std::string, int> left_frames = {
-        {"inequality", 2}, {"climate", 1}, {"action", 1}, {"regulation", 1},
-        {"workers", 1}, {"rights", 2}, {"justice", 2}, {"welfare", 1},
-        {"progressive", 2}, {"reform", 1}, {"revenue", 1}, {"investment", 1},
-        {"equity", 2}, {"protection", 1}, {"safety", 1}, {"access", 1}
-    };
-
-    std::map<std::string, int> right_frames = {
-        {"freedom", 2}, {"liberty", 2}, {"market", 1}, {"deregulation", 2},
-        {"business", 1}, {"growth", 1}, {"entrepreneur", 1}, {"innovation", 1},
-        {"conservative", 1}, {"traditional", 1}, {"fiscal", 1}, {"burden", 2},
-        {"radical", 2}, {"excessive", 1}, {"control", 1}, {"efficiency", 1}
-    };
-
-    // Define entities that carry political meaning
-    std::vector<std::string> left_entities = {
-        "climate", "environment", "healthcare", "education", "welfare",
-        "medicare", "social", "workers", "labor", "unions", "poor", "minorities"
-    };
-
-    std::vector<std::string> right_entities = {
-        "business", "market", "economy", "tax", "profit", "shareholders",
-        "enterprise", "corporations", "regulation", "government", "spending"
-    };
-
-    // Negative sentiment amplifiers (used with either frame to boost bias)
-    std::vector<std::string> negative_words = {
-        "dangerous", "threatens", "costly", "radical", "reckless", "failing",
-        "burden", "crisis", "disaster", "extreme", "harmful", "destructive"
-    };
-
-    std::vector<std::string> positive_words = {
-        "vital", "essential", "innovative", "freedom", "opportunity", "benefits",
-        "thriving", "success", "leadership", "growth", "progress", "reform"
-    };
-
-    // Calculate bigrams from tokens
-    left_terms = 0;
-    right_terms = 0;
+SignalOutput PolicyFramingSignal::compute(const NLPContext& ctx,
+                                           const ArticleInput& /*article*/) const {
+    // Single-word frames and context amplifiers come from the Lexicon,
+    // already tagged per token by the Preprocessor; multiword frames are
+    // matched here on the token ids, against the same lexicon version
+    const TokenFeatures& features = ctx.features;
+    const size_t token_count = ctx.token_count();
+    const uint32_t* ids = ctx.token_ids.data();
+    const PhraseTrie* phrases = ctx.lexicon ? &ctx.lexicon->phrases() : nullptr;
+
+    int left_terms = 0;
+    int right_terms = 0;
     double weighted_left_score = 0.0;
     double weighted_right_score = 0.0;
 
-    // Bigram detection for context-rich framing
-    std::map<std::string, int> bigram_left_frames = {
-        {"climate action", 2}, {"social justice", 2}, {"workers rights", 2},
-        {"public investment", 1}, {"healthcare reform", 1}, {"environmental protection", 2}
-    };
+    for (size_t i = 0; i < token_count; ++i) {
+        // Every phrase starting at token i, for context-rich framing;
+        // multiword phrases get 2x weight
+        if (phrases != nullptr && ids[i] != Vocabulary::kUnknown) {
+            phrases->match(ids, token_count, i, [&](const LexiconPhrase& phrase, size_t) {
+                if (phrase.frame_direction < 0) {
+                    weighted_left_score += phrase.frame_weight * 2;
+                    left_terms++;
+                } else {
+                    weighted_right_score += phrase.frame_weight * 2;
+                    right_terms++;
+                }
+            });
+        }
 
-    std::map<std::string, int> bigram_right_frames = {
-        {"free market", 2}, {"economic growth", 1}, {"job creation", 1},
-        {"business freedom", 2}, {"government overreach", 2}, {"fiscal responsibility", 2}
-    };
+        // Single-token frame with context (negative word before or positive
+        // word after reinforces the framing)
+        int direction = features.frame_direction[i];
+        if (direction == 0) {
+            continue;
+        }
 
-    // Check bigrams (two consecutive tokens)
-    for (size_t i = 0; i < ctx.tokens.size() - 1; ++i) {
-        std::string bigram = ctx.tokens[i] + " " + ctx.tokens[i+1];
-        
-        if (bigram_left_frames.find(bigram) != bigram_left_frames.end()) {
-            weighted_left_score += bigram_left_frames[bigram] * 2;  // Bigrams get 2x weight
-            left_terms++;
+        int context_boost = 1;
+        if (i > 0 && (features.context[i - 1] & kNegativeContext)) {
+            context_boost = 2;
         }
-        if (bigram_right_frames.find(bigram) != bigram_right_frames.end()) {
-            weighted_right_score += bigram_right_frames[bigram] * 2;
-            right_terms++;
+        if (i + 1 < token_count && (features.context[i + 1] & kPositiveContext)) {
+            context_boost = 2;
         }
-    }
 
-    // Single-token frame detection with context
-    for (size_t i = 0; i < ctx.tokens.size(); ++i) {
-        const auto& token = ctx.tokens[i];
-
-        // Check left frames
-        if (left_frames.find(token) != left_frames.end()) {
-            int weight = left_frames[token];
-            
-            // Check context (previous or next token for sentiment/entity reinforcement)
-            int context_boost = 1;
-            if (i > 0 && (std::find(negative_words.begin(), negative_words.end(), ctx.tokens[i-1]) != negative_words.end())) {
-                context_boost = 2;  // Negative context amplifies left bias
-            }
-            if (i < ctx.tokens.size() - 1 && (std::find(positive_words.begin(), positive_words.end(), ctx.tokens[i+1]) != positive_words.end())) {
-                context_boost = 2;  // Positive context amplifies left bias
-            }
-            
+        if (direction < 0) {
             left_terms++;
-            weighted_left_score += weight * context_boost;
-        }
-
-        // Check right frames
-        if (right_frames.find(token) != right_frames.end()) {
-            int weight = right_frames[token];
-            
-            // Check context for reinforcement
-            int context_boost = 1;
-            if (i > 0 && (std::find(negative_words.begin(), negative_words.end(), ctx.tokens[i-1]) != negative_words.end())) {
-                context_boost = 2;
-            }
-            if (i < ctx.tokens.size() - 1 && (std::find(positive_words.begin(), positive_words.end(), ctx.tokens[i+1]) != positive_words.end())) {
-                context_boost = 2;
-            }
-            
+            weighted_left_score += features.frame_weight[i] * context_boost;
+        } else {
             right_terms++;
-            weighted_right_score += weight * context_boost;
+            weighted_right_score += features.frame_weight[i] * context_boost;
         }
     }
 
@@ -118,7 +61,8 @@ double PolicyFramingSignal::compute(const NLPContext& ctx,
     // Use weighted scores instead of simple counts
     double total_weight = weighted_left_score + weighted_right_score;
     if (total_weight < 0.1) {
-        return 0.0;  // No significant policy framing detected
+        // No significant policy framing detected
+        return SignalOutput{.score = 0.0, .left = double(left_terms), .right = double(right_terms)};
     }
 
     // Bias score: (right_weight - left_weight) / total_weight
@@ -128,10 +72,12 @@ double PolicyFramingSignal::compute(const NLPContext& ctx,
     // Clamp to [-1, 1]
     score = std::max(-1.0, std::min(1.0, score));
     
-    return score;
+    return SignalOutput{.score = score, .left = double(left_terms), .right = double(right_terms)};
 }
 
-std::string PolicyFramingSignal::explain() const {
+std::string PolicyFramingSignal::explain(const SignalOutput& output) const {
+    const int left_terms = static_cast<int>(output.left);
+    const int right_terms = static_cast<int>(output.right);
     std::ostringstream oss;
     oss << "Policy framing: " << left_terms << " left-aligned terms, "
         << right_terms << " right-aligned terms";
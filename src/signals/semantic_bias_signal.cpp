@@ -1,4 +1,6 @@
 #include "../../include/signals/semantic_bias_signal.hpp"
+#include "../../include/similarity_kernel.hpp"
+#include "../../include/word_embeddings.hpp"
 #include <sstream>
 #include <cmath>
 #include <numeric>
@@ -14,8 +16,9 @@ void SemanticBiasSignal::build_reference_vectors() {
     // Left-wing semantic space: progressive political terminology
     // Dimensions represent different semantic aspects
     embedding_dim = 20;
-    left_vector.resize(embedding_dim, 0.0f);
-    right_vector.resize(embedding_dim, 0.0f);
+    reference_axes.assign(2 * embedding_dim, 0.0f);
+    float* left_vector = reference_axes.data();
+    float* right_vector = reference_axes.data() + embedding_dim;
 
     // Left vector: emphasizes collective values, regulation, progress, equity
     // Dimension breakdown:
@@ -42,66 +45,21 @@ void SemanticBiasSignal::build_reference_vectors() {
     }
 }
 
-std::vector<float> SemanticBiasSignal::embed_text(const std::string& text) {
-    // Create a semantic embedding based on keyword presence
+std::vector<float> SemanticBiasSignal::embed_text(const NLPContext& ctx) const {
+    // Create a semantic embedding from the political terminology tagged per
+    // token (see Lexicon: left terms add +0.3 to their dimension, right -0.3)
     // This is a simplified approach; in production, use transformer embeddings
     
     std::vector<float> embedding(embedding_dim, 0.0f);
-    
-    // Political terminology database
-    struct Term {
-        std::string word;
-        int dimension;  // Which semantic dimension
-        float polarity; // Positive = left-wing, negative = right-wing
-    };
-    
-    std::vector<Term> left_terms = {
-        {"equality", 0, 0.9f},      {"justice", 0, 0.9f},
-        {"community", 1, 0.8f},     {"collective", 1, 0.85f},
-        {"workers", 5, -0.7f},      {"rights", 5, -0.8f},
-        {"welfare", 10, 0.8f},      {"regulation", 10, 0.75f},
-        {"healthcare", 10, 0.7f},   {"environment", 10, 0.6f},
-        {"progress", 15, 0.8f},     {"reform", 15, 0.75f},
-        {"change", 15, 0.7f},       {"innovation", 15, 0.6f}
-    };
-    
-    std::vector<Term> right_terms = {
-        {"freedom", 5, -0.9f},      {"liberty", 5, -0.9f},
-        {"individual", 5, -0.85f},  {"personal", 5, -0.8f},
-        {"market", 10, -0.85f},     {"business", 10, -0.8f},
-        {"deregulation", 10, -0.9f},{"growth", 10, -0.7f},
-        {"tradition", 15, -0.8f},   {"family", 15, -0.7f},
-        {"stability", 15, -0.75f},  {"strength", 15, -0.7f}
-    };
+    const TokenFeatures& features = ctx.features;
 
-    // Count occurrences and accumulate contributions
+    // Accumulate contributions
     int total_terms_found = 0;
-    
-    for (const auto& term : left_terms) {
-        size_t pos = 0;
-        int count = 0;
-        while ((pos = text.find(term.word, pos)) != std::string::npos) {
-            count++;
-            pos += term.word.length();
-        }
-        if (count > 0) {
-            // Add to collectivism dimension if term is left-aligned
-            embedding[term.dimension] += count * 0.3f;
-            total_terms_found += count;
-        }
-    }
-    
-    for (const auto& term : right_terms) {
-        size_t pos = 0;
-        int count = 0;
-        while ((pos = text.find(term.word, pos)) != std::string::npos) {
-            count++;
-            pos += term.word.length();
-        }
-        if (count > 0) {
-            // Add to individualism dimension if term is right-aligned
-            embedding[term.dimension] += count * -0.3f;
-            total_terms_found += count;
+    for (size_t i = 0; i < features.semantic_dimension.size(); ++i) {
+        int dimension = features.semantic_dimension[i];
+        if (dimension >= 0 && dimension < embedding_dim) {
+            embedding[dimension] += features.semantic_weight[i];
+            total_terms_found++;
         }
     }
 
@@ -117,32 +75,12 @@ std::vector<float> SemanticBiasSignal::embed_text(const std::string& text) {
     return embedding;
 }
 
-double SemanticBiasSignal::cosine_similarity(const std::vector<float>& a, const std::vector<float>& b) {
-    if (a.size() != b.size() || a.empty()) return 0.0;
-    
-    double dot_product = 0.0;
-    double norm_a = 0.0;
-    double norm_b = 0.0;
-
-    for (size_t i = 0; i < a.size(); ++i) {
-        dot_product += a[i] * b[i];
-        norm_a += a[i] * a[i];
-        norm_b += b[i] * b[i];
-    }
-
-    norm_a = std::sqrt(norm_a);
-    norm_b = std::sqrt(norm_b);
-
-    if (norm_a < 1e-6 || norm_b < 1e-6) return 0.0;
-    
-    return dot_product / (norm_a * norm_b);
-}
-
-std::vector<std::string> SemanticBiasSignal::extract_nouns_verbs(const NLPContext& ctx) {
+std::vector<std::string_view> SemanticBiasSignal::extract_nouns_verbs(const NLPContext& ctx) const {
     // Simple filtering: keep substantial tokens
-    std::vector<std::string> nouns_verbs;
+    std::vector<std::string_view> nouns_verbs;
     
-    for (const auto& token : ctx.tokens) {
+    for (size_t i = 0; i < ctx.token_count(); ++i) {
+        std::string_view token = ctx.token(i);
         if (token.length() > 2) {
             nouns_verbs.push_back(token);
         }
@@ -151,36 +89,55 @@ std::vector<std::string> SemanticBiasSignal::extract_nouns_verbs(const NLPContex
     return nouns_verbs;
 }
 
-double SemanticBiasSignal::compute(const NLPContext& ctx, const ArticleInput& article) {
-    // Combine article text
-    std::string full_text = article.title + " " + article.body;
-    
-    // Convert to lowercase for matching
-    std::transform(full_text.begin(), full_text.end(), full_text.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    
-    // Get semantic embedding for article
-    auto article_embedding = embed_text(full_text);
-    
-    // Calculate similarity to political vectors
-    last_left_similarity = cosine_similarity(article_embedding, left_vector);
-    last_right_similarity = cosine_similarity(article_embedding, right_vector);
+SignalOutput SemanticBiasSignal::compute(const NLPContext& ctx, const ArticleInput& /*article*/) const {
+    double left_similarity;
+    double right_similarity;
+
+    // The word vectors the Preprocessor embedded this article with
+    const WordEmbeddings* embeddings = ctx.embedding.empty() ? nullptr : ctx.embeddings.get();
+    const int left_index = embeddings ? embeddings->reference_index("left") : -1;
+    const int right_index = embeddings ? embeddings->reference_index("right") : -1;
+
+    if (left_index >= 0 && right_index >= 0) {
+        // Pretrained vectors: article embedding vs every seed-built reference
+        // in one kernel call, unless analyze_batch() already scored it
+        // together with the rest of its batch
+        const float* similarity = ctx.reference_similarity.data();
+        std::vector<float> computed;
+        if (ctx.reference_similarity.size() != embeddings->reference_count()) {
+            computed.resize(embeddings->reference_count());
+            embeddings->similarities(ctx.embedding.data(), 1, computed.data());
+            similarity = computed.data();
+        }
+        left_similarity = similarity[left_index];
+        right_similarity = similarity[right_index];
+    } else {
+        // Get semantic embedding for article
+        auto article_embedding = embed_text(ctx);
+
+        // Calculate similarity to political vectors
+        float similarity[2];
+        SimilarityKernel::cosine(article_embedding.data(), 1, reference_axes.data(), 2,
+                                 embedding_dim, similarity);
+        left_similarity = similarity[0];
+        right_similarity = similarity[1];
+    }
     
     // Score: right vs left alignment
     // Positive = right-leaning, Negative = left-leaning
-    double score = last_right_similarity - last_left_similarity;
+    double score = right_similarity - left_similarity;
     
     // Clamp to [-1, 1]
     score = std::max(-1.0, std::min(1.0, score));
     
-    return score;
+    return SignalOutput{.score = score, .left = left_similarity, .right = right_similarity};
 }
 
-std::string SemanticBiasSignal::explain() const {
+std::string SemanticBiasSignal::explain(const SignalOutput& output) const {
     std::ostringstream oss;
-    oss << "Semantic bias: left=" << last_left_similarity 
-        << ", right=" << last_right_similarity
-        << " → " << (last_right_similarity > last_left_similarity ? "right" : "left")
+    oss << "Semantic bias: left=" << output.left 
+        << ", right=" << output.right
+        << " → " << (output.right > output.left ? "right" : "left")
         << "-leaning semantic space";
     return oss.str();
 }
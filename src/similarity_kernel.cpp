@@ -0,0 +1,338 @@
+#include "../include/similarity_kernel.hpp"
+#include "../include/half_float.hpp"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define BIAS_DETECTOR_HAVE_X86_KERNELS 1
+#endif
+
+namespace {
+
+constexpr float kMinNorm = 1e-6f;
+
+// Dot products of x with one or four vectors of length n, and
+// out += scale * x for float and binary16 x
+struct DotOps {
+    float (*dot1)(const float* x, const float* a, size_t n);
+    void (*dot4)(const float* x, const float* const* a, size_t n, float* out);
+    void (*axpy)(float scale, const float* x, size_t n, float* out);
+    void (*axpy_half)(float scale, const uint16_t* x, size_t n, float* out);
+};
+
+float dot1_scalar(const float* x, const float* a, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += x[i] * a[i];
+    }
+    return sum;
+}
+
+void dot4_scalar(const float* x, const float* const* a, size_t n, float* out) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        s0 += x[i] * a[0][i];
+        s1 += x[i] * a[1][i];
+        s2 += x[i] * a[2][i];
+        s3 += x[i] * a[3][i];
+    }
+    out[0] = s0;
+    out[1] = s1;
+    out[2] = s2;
+    out[3] = s3;
+}
+
+void axpy_scalar(float scale, const float* x, size_t n, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] += scale * x[i];
+    }
+}
+
+void axpy_half_scalar(float scale, const uint16_t* x, size_t n, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] += scale * half_to_float(x[i]);
+    }
+}
+
+#ifdef BIAS_DETECTOR_HAVE_X86_KERNELS
+
+__attribute__((target("avx2,fma"))) inline float hsum_avx2(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma"))) float dot1_avx2(const float* x, const float* a, size_t n) {
+    __m256 s = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(a + i), s);
+    }
+    float sum = hsum_avx2(s);
+    for (; i < n; ++i) {
+        sum += x[i] * a[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma"))) void dot4_avx2(const float* x, const float* const* a,
+                                                    size_t n, float* out) {
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+    __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        s0 = _mm256_fmadd_ps(v, _mm256_loadu_ps(a[0] + i), s0);
+        s1 = _mm256_fmadd_ps(v, _mm256_loadu_ps(a[1] + i), s1);
+        s2 = _mm256_fmadd_ps(v, _mm256_loadu_ps(a[2] + i), s2);
+        s3 = _mm256_fmadd_ps(v, _mm256_loadu_ps(a[3] + i), s3);
+    }
+    out[0] = hsum_avx2(s0);
+    out[1] = hsum_avx2(s1);
+    out[2] = hsum_avx2(s2);
+    out[3] = hsum_avx2(s3);
+    for (; i < n; ++i) {
+        out[0] += x[i] * a[0][i];
+        out[1] += x[i] * a[1][i];
+        out[2] += x[i] * a[2][i];
+        out[3] += x[i] * a[3][i];
+    }
+}
+
+__attribute__((target("avx2,fma"))) void axpy_avx2(float scale, const float* x,
+                                                    size_t n, float* out) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(s, _mm256_loadu_ps(x + i), _mm256_loadu_ps(out + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] += scale * x[i];
+    }
+}
+
+__attribute__((target("avx2,fma,f16c"))) void axpy_half_avx2(float scale, const uint16_t* x,
+                                                             size_t n, float* out) {
+    const __m256 s = _mm256_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        _mm256_storeu_ps(out + i, _mm256_fmadd_ps(s, v, _mm256_loadu_ps(out + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] += scale * half_to_float(x[i]);
+    }
+}
+
+// Halves down to 128 bits, then as hsum_avx2. GCC's unmasked 512-to-256
+// extracts and casts (and _mm512_reduce_add_ps, built on them) pass an
+// undefined vector that trips -Wuninitialized; the zero-masked forms don't
+__attribute__((target("avx512f"))) inline float hsum_avx512(__m512 v) {
+    const __m512d wide = _mm512_castps_pd(v);
+    const __m256 low = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, wide, 0));
+    const __m256 high = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, wide, 1));
+    const __m256 half = _mm256_add_ps(low, high);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+// The tail is handled with masked loads, so there is no scalar remainder
+__attribute__((target("avx512f"))) float dot1_avx512(const float* x, const float* a, size_t n) {
+    __m512 s = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(a + i), s);
+    }
+    if (i < n) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        s = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, a + i), s);
+    }
+    return hsum_avx512(s);
+}
+
+__attribute__((target("avx512f"))) void dot4_avx512(const float* x, const float* const* a,
+                                                     size_t n, float* out) {
+    __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+    __m512 s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_loadu_ps(x + i);
+        s0 = _mm512_fmadd_ps(v, _mm512_loadu_ps(a[0] + i), s0);
+        s1 = _mm512_fmadd_ps(v, _mm512_loadu_ps(a[1] + i), s1);
+        s2 = _mm512_fmadd_ps(v, _mm512_loadu_ps(a[2] + i), s2);
+        s3 = _mm512_fmadd_ps(v, _mm512_loadu_ps(a[3] + i), s3);
+    }
+    if (i < n) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512 v = _mm512_maskz_loadu_ps(mask, x + i);
+        s0 = _mm512_fmadd_ps(v, _mm512_maskz_loadu_ps(mask, a[0] + i), s0);
+        s1 = _mm512_fmadd_ps(v, _mm512_maskz_loadu_ps(mask, a[1] + i), s1);
+        s2 = _mm512_fmadd_ps(v, _mm512_maskz_loadu_ps(mask, a[2] + i), s2);
+        s3 = _mm512_fmadd_ps(v, _mm512_maskz_loadu_ps(mask, a[3] + i), s3);
+    }
+    out[0] = hsum_avx512(s0);
+    out[1] = hsum_avx512(s1);
+    out[2] = hsum_avx512(s2);
+    out[3] = hsum_avx512(s3);
+}
+
+__attribute__((target("avx512f"))) void axpy_avx512(float scale, const float* x,
+                                                     size_t n, float* out) {
+    const __m512 s = _mm512_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(out + i, _mm512_fmadd_ps(s, _mm512_loadu_ps(x + i), _mm512_loadu_ps(out + i)));
+    }
+    if (i < n) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512 v = _mm512_maskz_loadu_ps(mask, x + i);
+        _mm512_mask_storeu_ps(out + i, mask, _mm512_fmadd_ps(s, v, _mm512_maskz_loadu_ps(mask, out + i)));
+    }
+}
+
+__attribute__((target("avx512f"))) void axpy_half_avx512(float scale, const uint16_t* x,
+                                                          size_t n, float* out) {
+    const __m512 s = _mm512_set1_ps(scale);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        // Zero-masked for the same reason as in hsum_avx512
+        const __m256i half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m512 v = _mm512_maskz_cvtph_ps(0xFFFF, half);
+        _mm512_storeu_ps(out + i, _mm512_fmadd_ps(s, v, _mm512_loadu_ps(out + i)));
+    }
+    for (; i < n; ++i) {
+        out[i] += scale * half_to_float(x[i]);
+    }
+}
+
+#endif  // BIAS_DETECTOR_HAVE_X86_KERNELS
+
+DotOps ops_for(SimilarityKernel::Isa isa) {
+#ifdef BIAS_DETECTOR_HAVE_X86_KERNELS
+    if (SimilarityKernel::supported(isa)) {
+        if (isa == SimilarityKernel::Isa::Avx512) {
+            return DotOps{dot1_avx512, dot4_avx512, axpy_avx512, axpy_half_avx512};
+        }
+        if (isa == SimilarityKernel::Isa::Avx2) {
+            return DotOps{dot1_avx2, dot4_avx2, axpy_avx2, axpy_half_avx2};
+        }
+    }
+#else
+    (void)isa;
+#endif
+    return DotOps{dot1_scalar, dot4_scalar, axpy_scalar, axpy_half_scalar};
+}
+
+// Kernels of the best instruction set, picked on first use
+const DotOps& best_ops() {
+    static const DotOps ops = ops_for(SimilarityKernel::best());
+    return ops;
+}
+
+inline float cosine_of(float dot, float norm_x, float norm_a) {
+    return (norm_x < kMinNorm || norm_a < kMinNorm) ? 0.0f : dot / (norm_x * norm_a);
+}
+
+void run(const DotOps& ops, const float* rows, size_t batch,
+         const float* axes, size_t axis_count, size_t dim, float* out) {
+    // Axes are processed in chunks whose norms fit on the stack; typical
+    // callers have far fewer axes than one chunk
+    constexpr size_t kAxisChunk = 64;
+    float axis_norms[kAxisChunk];
+
+    for (size_t first = 0; first < axis_count; first += kAxisChunk) {
+        const size_t chunk = (axis_count - first < kAxisChunk) ? axis_count - first : kAxisChunk;
+        for (size_t a = 0; a < chunk; ++a) {
+            const float* axis = axes + (first + a) * dim;
+            axis_norms[a] = std::sqrt(ops.dot1(axis, axis, dim));
+        }
+
+        for (size_t b = 0; b < batch; ++b) {
+            const float* row = rows + b * dim;
+            const float row_norm = std::sqrt(ops.dot1(row, row, dim));
+            float* row_out = out + b * axis_count + first;
+
+            size_t a = 0;
+            for (; a + 4 <= chunk; a += 4) {
+                const float* block[4] = {
+                    axes + (first + a) * dim,
+                    axes + (first + a + 1) * dim,
+                    axes + (first + a + 2) * dim,
+                    axes + (first + a + 3) * dim,
+                };
+                float dots[4];
+                ops.dot4(row, block, dim, dots);
+                for (size_t k = 0; k < 4; ++k) {
+                    row_out[a + k] = cosine_of(dots[k], row_norm, axis_norms[a + k]);
+                }
+            }
+            for (; a < chunk; ++a) {
+                float dot = ops.dot1(row, axes + (first + a) * dim, dim);
+                row_out[a] = cosine_of(dot, row_norm, axis_norms[a]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+bool SimilarityKernel::supported(Isa isa) {
+#ifdef BIAS_DETECTOR_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+#endif
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+#ifdef BIAS_DETECTOR_HAVE_X86_KERNELS
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                   __builtin_cpu_supports("f16c");
+        case Isa::Avx512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+SimilarityKernel::Isa SimilarityKernel::best() {
+    static const Isa detected = supported(Isa::Avx512) ? Isa::Avx512
+                              : supported(Isa::Avx2)   ? Isa::Avx2
+                                                       : Isa::Scalar;
+    return detected;
+}
+
+const char* SimilarityKernel::name(Isa isa) {
+    switch (isa) {
+        case Isa::Avx512: return "avx512";
+        case Isa::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+void SimilarityKernel::cosine(const float* rows, size_t batch,
+                              const float* axes, size_t axis_count,
+                              size_t dim, float* out) {
+    run(best_ops(), rows, batch, axes, axis_count, dim, out);
+}
+
+float SimilarityKernel::dot(const float* a, const float* b, size_t dim) {
+    return best_ops().dot1(a, b, dim);
+}
+
+void SimilarityKernel::accumulate(float scale, const float* x, size_t dim, float* out) {
+    best_ops().axpy(scale, x, dim, out);
+}
+
+void SimilarityKernel::accumulate(float scale, const uint16_t* x, size_t dim, float* out) {
+    best_ops().axpy_half(scale, x, dim, out);
+}
+
+void SimilarityKernel::cosine(Isa isa, const float* rows, size_t batch,
+                              const float* axes, size_t axis_count,
+                              size_t dim, float* out) {
+    run(ops_for(isa), rows, batch, axes, axis_count, dim, out);
+}
@@ -0,0 +1,91 @@
+#include "../include/thread_pool.hpp"
+
+ThreadPool::ThreadPool(size_t count) {
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    if (count == 0) {
+        count = 1;
+    }
+
+    threads.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        threads.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(size_t count,
+                              const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &fn;
+    job_count = count;
+    next_index.store(0, std::memory_order_relaxed);
+    active_workers = threads.size();
+    failure = nullptr;
+    ++generation;
+    work_ready.notify_all();
+
+    work_done.wait(lock, [this] { return active_workers == 0; });
+    job = nullptr;
+
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::worker_loop(size_t worker) {
+    size_t seen_generation = 0;
+
+    for (;;) {
+        const std::function<void(size_t, size_t)>* fn;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            fn = job;
+            count = job_count;
+        }
+
+        // Items are whole articles, so one index per fetch_add is cheap next
+        // to the work and gives the best balance at the tail of a batch.
+        try {
+            for (size_t i = next_index.fetch_add(1, std::memory_order_relaxed);
+                 i < count;
+                 i = next_index.fetch_add(1, std::memory_order_relaxed)) {
+                (*fn)(worker, i);
+            }
+        } catch (...) {
+            next_index.store(count, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--active_workers == 0) {
+            work_done.notify_one();
+        }
+    }
+}
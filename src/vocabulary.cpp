@@ -0,0 +1,105 @@
+#include "../include/vocabulary.hpp"
+#include "../include/hash.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Map a 32-bit value uniformly onto [0, range) without a division
+inline uint32_t fast_range(uint32_t value, uint32_t range) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(value) * range) >> 32);
+}
+
+}  // namespace
+
+uint32_t Vocabulary::bucket_of(uint64_t hash, uint32_t bucket_count) {
+    return fast_range(static_cast<uint32_t>(hash >> 32), bucket_count);
+}
+
+uint32_t Vocabulary::slot_of(uint64_t hash, uint32_t displacement, uint32_t slot_count) {
+    uint64_t mixed = hash_mix(hash + displacement * 0x9E3779B97F4A7C15ULL);
+    return fast_range(static_cast<uint32_t>(mixed), slot_count);
+}
+
+uint32_t Vocabulary::find(std::string_view word) const {
+    if (slot_count == 0 || word.empty()) {
+        return kUnknown;
+    }
+    return find(word, hash_bytes(word));
+}
+
+uint32_t Vocabulary::find(std::string_view word, uint64_t h) const {
+    if (slot_count == 0 || word.empty()) {
+        return kUnknown;
+    }
+
+    uint32_t id = slot_of(h, displacements[bucket_of(h, bucket_count)], slot_count) + 1;
+    return (this->word(id) == word) ? id : kUnknown;
+}
+
+VocabularyLayout Vocabulary::layout(const std::vector<uint64_t>& hashes) {
+    const uint32_t n = static_cast<uint32_t>(hashes.size());
+
+    // Hash-and-displace: ~4 keys per bucket, ~90% slot load. Buckets are
+    // placed largest first; each gets the first displacement that sends all
+    // of its keys to free, distinct slots.
+    VocabularyLayout result;
+    uint32_t slot_count = (n == 0) ? 0 : n + n / 8 + 1;
+    uint32_t bucket_count = (n == 0) ? 0 : std::max<uint32_t>(1, (n + 3) / 4);
+    std::vector<uint32_t> displacements(bucket_count, 0);
+    std::vector<uint32_t> slot_key;
+
+    for (bool placed = (n == 0); !placed; slot_count += slot_count / 16 + 1) {
+        std::vector<std::vector<uint32_t>> buckets(bucket_count);
+        for (uint32_t i = 0; i < n; ++i) {
+            buckets[bucket_of(hashes[i], bucket_count)].push_back(i);
+        }
+        std::vector<uint32_t> order(bucket_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        slot_key.assign(slot_count, 0);
+        std::vector<uint32_t> trial;
+        placed = true;
+        for (uint32_t bucket : order) {
+            const auto& keys = buckets[bucket];
+            if (keys.empty()) {
+                break;  // sorted by size: the rest are empty too
+            }
+            bool found = false;
+            for (uint32_t d = 0; d < (1u << 20) && !found; ++d) {
+                trial.clear();
+                found = true;
+                for (uint32_t key : keys) {
+                    uint32_t slot = slot_of(hashes[key], d, slot_count);
+                    if (slot_key[slot] != 0 || std::find(trial.begin(), trial.end(), slot) != trial.end()) {
+                        found = false;
+                        break;
+                    }
+                    trial.push_back(slot);
+                }
+                if (found) {
+                    displacements[bucket] = d;
+                    for (size_t k = 0; k < keys.size(); ++k) {
+                        slot_key[trial[k]] = keys[k] + 1;
+                    }
+                }
+            }
+            if (!found) {
+                placed = false;  // grow the table and start over
+                break;
+            }
+        }
+        if (placed) {
+            break;
+        }
+    }
+
+    result.slot_count = slot_count;
+    result.bucket_count = bucket_count;
+    result.displacements = std::move(displacements);
+    result.slot_key = std::move(slot_key);
+    return result;
+}
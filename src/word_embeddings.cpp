@@ -0,0 +1,200 @@
+#include "../include/word_embeddings.hpp"
+#include "../include/embedding_builder.hpp"
+#include "../include/nlp_context.hpp"
+#include "../include/published.hpp"
+#include "../include/similarity_kernel.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// kDefaultImagePath; nullptr if it is missing or invalid
+std::shared_ptr<const WordEmbeddings> load_deployed() {
+    auto embeddings = std::make_shared<WordEmbeddings>();
+    if (embeddings->load(WordEmbeddings::kDefaultImagePath)) {
+        return embeddings;
+    }
+    return nullptr;
+}
+
+Published<WordEmbeddings>& published_embeddings() {
+    static Published<WordEmbeddings> published([] {
+        std::shared_ptr<const WordEmbeddings> embeddings = load_deployed();
+        return embeddings ? embeddings : std::make_shared<const WordEmbeddings>();
+    }());
+    return published;
+}
+
+size_t element_size(uint32_t precision) {
+    return precision == static_cast<uint32_t>(EmbeddingPrecision::Float16) ? 2 : 4;
+}
+
+}  // namespace
+
+WordEmbeddings::WordEmbeddings() {
+    load_image(EmbeddingBuilder().compile(EmbeddingPrecision::Float32));
+}
+
+std::shared_ptr<const WordEmbeddings> WordEmbeddings::current() {
+    return published_embeddings().acquire();
+}
+
+std::shared_ptr<const WordEmbeddings> WordEmbeddings::current(uint64_t& version) {
+    return published_embeddings().acquire(version);
+}
+
+uint64_t WordEmbeddings::version() {
+    return published_embeddings().version();
+}
+
+void WordEmbeddings::publish(std::shared_ptr<const WordEmbeddings> embeddings) {
+    published_embeddings().publish(std::move(embeddings));
+}
+
+bool WordEmbeddings::reload() {
+    std::shared_ptr<const WordEmbeddings> embeddings = load_deployed();
+    if (!embeddings) {
+        return false;
+    }
+    publish(std::move(embeddings));
+    return true;
+}
+
+bool WordEmbeddings::load(const std::string& image_path) {
+    MappedFile mapped;
+    if (!mapped.open(image_path) || !validate(mapped.data(), mapped.size())) {
+        return false;
+    }
+    file = std::move(mapped);
+    owned.clear();
+    attach(file.data());
+    return true;
+}
+
+bool WordEmbeddings::load_image(std::vector<uint8_t> image) {
+    if (!validate(image.data(), image.size())) {
+        return false;
+    }
+    owned = std::move(image);
+    file.close();
+    attach(owned.data());
+    return true;
+}
+
+bool WordEmbeddings::validate(const uint8_t* data, size_t size) {
+    if (data == nullptr || size < sizeof(EmbeddingImageHeader) ||
+        reinterpret_cast<uintptr_t>(data) % alignof(EmbeddingImageHeader) != 0) {
+        return false;
+    }
+    const auto& header = *reinterpret_cast<const EmbeddingImageHeader*>(data);
+    if (std::memcmp(header.magic, kEmbeddingImageMagic, sizeof(header.magic)) != 0 ||
+        header.version != kEmbeddingImageVersion || header.total_size != size ||
+        header.precision > static_cast<uint32_t>(EmbeddingPrecision::Float16)) {
+        return false;
+    }
+
+    auto section_fits = [size](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t slots = header.slot_count;
+    const uint64_t dimension = header.dimension;
+    if (!section_fits(header.word_offsets, 4 * (slots + 2)) ||
+        !section_fits(header.displacements, 4ull * header.bucket_count) ||
+        !section_fits(header.weights, 4 * (slots + 1)) ||
+        !section_fits(header.vectors, element_size(header.precision) * (slots + 1) * dimension) ||
+        !section_fits(header.reference_offsets, 4ull * (header.reference_count + 1ull)) ||
+        !section_fits(header.references, 4 * dimension * header.reference_count) ||
+        (slots > 0 && header.bucket_count == 0)) {
+        return false;
+    }
+
+    // Blob lengths come from the last offset of each table
+    const auto* word_offsets = reinterpret_cast<const uint32_t*>(data + header.word_offsets);
+    const auto* reference_offsets = reinterpret_cast<const uint32_t*>(data + header.reference_offsets);
+    if (!section_fits(header.word_blob, word_offsets[slots + 1]) ||
+        !section_fits(header.reference_blob, reference_offsets[header.reference_count])) {
+        return false;
+    }
+    for (uint64_t id = 0; id <= slots; ++id) {
+        if (word_offsets[id] > word_offsets[id + 1]) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header.reference_count; ++i) {
+        if (reference_offsets[i] > reference_offsets[i + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WordEmbeddings::attach(const uint8_t* data) {
+    const auto& header = *reinterpret_cast<const EmbeddingImageHeader*>(data);
+
+    vocab = Vocabulary(reinterpret_cast<const uint32_t*>(data + header.word_offsets),
+                       reinterpret_cast<const char*>(data + header.word_blob),
+                       reinterpret_cast<const uint32_t*>(data + header.displacements),
+                       header.slot_count, header.bucket_count);
+    weights = reinterpret_cast<const float*>(data + header.weights);
+    vectors = data + header.vectors;
+    reference_offsets = reinterpret_cast<const uint32_t*>(data + header.reference_offsets);
+    reference_blob = reinterpret_cast<const char*>(data + header.reference_blob);
+    references = reinterpret_cast<const float*>(data + header.references);
+    dim = header.dimension;
+    word_total = header.word_count;
+    reference_total = header.reference_count;
+    model_fingerprint = header.fingerprint;
+    storage = static_cast<EmbeddingPrecision>(header.precision);
+}
+
+void WordEmbeddings::accumulate(uint32_t id, float scale, float* out) const {
+    const size_t n = dim;
+    if (storage == EmbeddingPrecision::Float32) {
+        const float* row = reinterpret_cast<const float*>(vectors) + static_cast<size_t>(id) * n;
+        SimilarityKernel::accumulate(scale, row, n, out);
+    } else {
+        const uint16_t* row = reinterpret_cast<const uint16_t*>(vectors) + static_cast<size_t>(id) * n;
+        SimilarityKernel::accumulate(scale, row, n, out);
+    }
+}
+
+void WordEmbeddings::copy(uint32_t id, float* out) const {
+    std::fill(out, out + dim, 0.0f);
+    accumulate(id, 1.0f, out);
+}
+
+void WordEmbeddings::embed(const NLPContext& ctx, float* out) const {
+    // Frequent words weigh little; the division by the total weight is
+    // skipped, cosine ignores the scale. Each token's hash was computed by
+    // the Preprocessor, so a lookup is the slot arithmetic plus one compare
+    std::fill(out, out + dim, 0.0f);
+    for (size_t i = 0; i < ctx.token_count(); ++i) {
+        uint32_t id = vocab.find(ctx.token(i), ctx.token_hashes[i]);
+        if (id != Vocabulary::kUnknown) {
+            accumulate(id, weights[id], out);
+        }
+    }
+}
+
+const float* WordEmbeddings::reference(std::string_view name) const {
+    int index = reference_index(name);
+    return (index < 0) ? nullptr : references + static_cast<size_t>(index) * dim;
+}
+
+int WordEmbeddings::reference_index(std::string_view name) const {
+    for (uint32_t i = 0; i < reference_total; ++i) {
+        if (reference_name(i) == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void WordEmbeddings::similarities(const float* rows, size_t batch, float* out) const {
+    SimilarityKernel::cosine(rows, batch, references, reference_total, dim, out);
+}
+
+std::string_view WordEmbeddings::reference_name(uint32_t index) const {
+    return std::string_view(reference_blob + reference_offsets[index],
+                            reference_offsets[index + 1] - reference_offsets[index]);
+}
@@ -0,0 +1,95 @@
+#include "include/preprocessor.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Global operator new replaced with a counting version; counts only while a
+// test has switched counting on so Google Test's own allocations are ignored.
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<size_t> allocations{0};
+
+void* counted_alloc(size_t size) {
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(size_t size) { return counted_alloc(size); }
+void* operator new[](size_t size) { return counted_alloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+std::vector<ArticleInput> make_articles() {
+    const char* sentences[] = {
+        "Democrats called the bill a victory for worker rights and social equity. ",
+        "Republicans warned about government overreach and rising regulatory burden. ",
+        "Trump told supporters in Ohio that border security comes first! ",
+        "Biden said the climate plan would create jobs. Critics were furious? ",
+        "The Senate vote was delayed again after a heated and disastrous debate. ",
+    };
+    std::vector<ArticleInput> articles;
+    for (size_t a = 0; a < 5; ++a) {
+        ArticleInput article;
+        article.title = "Story " + std::to_string(a) + ": Congress fights over the budget";
+        for (size_t i = 0; i < 6 + a; ++i) {
+            article.body += sentences[(a + i) % 5];
+        }
+        article.domain = "example.com";
+        articles.push_back(article);
+    }
+    return articles;
+}
+
+}  // namespace
+
+TEST(Allocations, ProcessIntoReusedContextAllocatesNothingAfterWarmUp) {
+    const Preprocessor preprocessor;
+    const std::vector<ArticleInput> articles = make_articles();
+    static thread_local NLPContext ctx;
+
+    // Warm up on every article so the context's buffers reach the sizes
+    // the largest one needs (and the lexicon is loaded)
+    for (const ArticleInput& article : articles) {
+        preprocessor.process(article, ctx);
+    }
+    ASSERT_FALSE(ctx.tokens.empty());
+
+    for (int round = 0; round < 3; ++round) {
+        for (const ArticleInput& article : articles) {
+            allocations.store(0);
+            counting.store(true);
+            preprocessor.process(article, ctx);
+            counting.store(false);
+            EXPECT_EQ(allocations.load(), 0u) << "article: " << article.title;
+        }
+    }
+
+    // A fresh context does allocate, so the counter is live
+    NLPContext fresh;
+    allocations.store(0);
+    counting.store(true);
+    preprocessor.process(articles.front(), fresh);
+    counting.store(false);
+    EXPECT_GT(allocations.load(), 0u);
+}
@@ -0,0 +1,63 @@
+#include "include/lexicon.hpp"
+#include "include/lexicon_builder.hpp"
+#include "include/phrase_trie.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> small_image() {
+    LexiconBuilder builder;
+    builder.word("tax").frame_direction = 1;
+    builder.add_phrase({"death", "tax"}, 1, 3);
+    builder.add_phrase({"free", "market", "reform"}, 1, 2);
+    builder.add_entity("bernie sanders", Ideology::Left);
+    builder.add_entity("ted cruz", Ideology::Right);
+    return builder.compile();
+}
+
+const LexiconImageHeader& header_of(const std::vector<uint8_t>& image) {
+    return *reinterpret_cast<const LexiconImageHeader*>(image.data());
+}
+
+// First occupied phrase edge slot
+PhraseEdge* first_edge(std::vector<uint8_t>& image) {
+    auto* edges = reinterpret_cast<PhraseEdge*>(image.data() + header_of(image).phrase_edges);
+    for (uint32_t i = 0; i < header_of(image).phrase_slot_count; ++i) {
+        if (edges[i].to != 0) {
+            return &edges[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+TEST(Lexicon, LoadsCompiledImage) {
+    Lexicon lexicon;
+    EXPECT_TRUE(lexicon.load_image(small_image()));
+    EXPECT_EQ(lexicon.entity_count(), 2u);
+}
+
+TEST(Lexicon, RejectsOutOfRangeIdeology) {
+    std::vector<uint8_t> image = small_image();
+    image[header_of(image).entity_ideologies + 1] = 4;
+    Lexicon lexicon;
+    EXPECT_FALSE(lexicon.load_image(image));
+}
+
+TEST(Lexicon, RejectsPhraseEdgeToMissingState) {
+    std::vector<uint8_t> image = small_image();
+    PhraseEdge* edge = first_edge(image);
+    ASSERT_NE(edge, nullptr);
+    edge->to = 0xFFFFFFF0u;
+    Lexicon lexicon;
+    EXPECT_FALSE(lexicon.load_image(image));
+
+    // A word id is not an inner state either
+    image = small_image();
+    first_edge(image)->to = 1;
+    EXPECT_FALSE(lexicon.load_image(image));
+}
@@ -0,0 +1,80 @@
+#include "include/near_duplicate_index.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+ResultCache::Entry make_entry(size_t token_count, uint64_t generation = 1) {
+    ResultCache::Entry entry;
+    entry.token_count = token_count;
+    entry.generation = generation;
+    return entry;
+}
+
+}  // namespace
+
+TEST(NearDuplicateIndex, FindsFingerprintsWithinMaxDistance) {
+    NearDuplicateIndex index(16, 6);
+    const uint64_t base = 0x0123456789ABCDEFull;
+    index.insert(base, make_entry(11));
+
+    ResultCache::Entry out;
+    EXPECT_TRUE(index.find(base, 1, out));
+    EXPECT_EQ(out.token_count, 11u);
+
+    // Six flipped bits, spread over different bands and inside one band
+    EXPECT_TRUE(index.find(base ^ 0x8000100002000041ull, 1, out));
+    EXPECT_TRUE(index.find(base ^ 0x3Full, 1, out));
+
+    // Seven bits is past the limit; a different generation never matches
+    EXPECT_FALSE(index.find(base ^ 0x7Full, 1, out));
+    EXPECT_FALSE(index.find(base ^ 0xFFFF0000FFFF0000ull, 1, out));
+    EXPECT_FALSE(index.find(base, 2, out));
+}
+
+TEST(NearDuplicateIndex, EditedArticleIsANearDuplicate) {
+    ArticleInput article;
+    article.title = "Senate passes the climate bill after weeks of debate";
+    for (int i = 0; i < 8; ++i) {
+        article.body += "Sentence number " + std::to_string(i) +
+                        " describes the vote, the amendments and the reaction in the chamber. ";
+    }
+    ArticleInput edited = article;
+    edited.body += "Updated with comment from the minority leader.";
+
+    ArticleInput unrelated;
+    unrelated.title = "Local team wins the championship in overtime";
+    unrelated.body = "Fans celebrated downtown after the final whistle as the coach praised "
+                     "the defence and the rookie goalkeeper made a record number of saves.";
+
+    NearDuplicateIndex index(16, 6);
+    index.insert(NearDuplicateIndex::fingerprint(article), make_entry(42));
+
+    ResultCache::Entry out;
+    EXPECT_TRUE(index.find(NearDuplicateIndex::fingerprint(edited), 1, out));
+    EXPECT_EQ(out.token_count, 42u);
+    EXPECT_FALSE(index.find(NearDuplicateIndex::fingerprint(unrelated), 1, out));
+}
+
+TEST(NearDuplicateIndex, EvictedEntryIsNoLongerReturned) {
+    NearDuplicateIndex index(2, 6);
+    const uint64_t first = 0x0000000000000000ull;
+    const uint64_t second = 0x00000000FFFFFFFFull;
+    const uint64_t third = 0xFFFFFFFF00000000ull;
+
+    index.insert(first, make_entry(1));
+    index.insert(second, make_entry(2));
+    index.insert(third, make_entry(3));  // replaces the oldest, first
+
+    ResultCache::Entry out;
+    EXPECT_FALSE(index.find(first, 1, out));
+    EXPECT_FALSE(index.find(first ^ 0x3ull, 1, out));
+    ASSERT_TRUE(index.find(second, 1, out));
+    EXPECT_EQ(out.token_count, 2u);
+    ASSERT_TRUE(index.find(third, 1, out));
+    EXPECT_EQ(out.token_count, 3u);
+
+    NearDuplicateIndex::Stats stats = index.stats();
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.capacity, 2u);
+}
@@ -0,0 +1,129 @@
+#include "include/bias_aggregator.hpp"
+#include "include/result_cache.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+// Long enough and with enough entities to pass the refusal checks
+ArticleInput make_article(const std::string& domain) {
+    ArticleInput article;
+    article.title = "Senate passes the climate bill after weeks of debate";
+    for (int i = 0; i < 8; ++i) {
+        article.body += "Democrats called the bill a victory for worker rights and social equity. "
+                        "Republicans warned about government overreach and rising regulatory burden. "
+                        "Trump told supporters that border security comes first. ";
+    }
+    article.domain = domain;
+    article.url = "https://" + domain + "/story";
+    return article;
+}
+
+void expect_same_output(const SignalOutput& a, const SignalOutput& b) {
+    EXPECT_EQ(a.score, b.score);
+    EXPECT_EQ(a.left, b.left);
+    EXPECT_EQ(a.right, b.right);
+    EXPECT_EQ(a.abstained, b.abstained);
+}
+
+void expect_same_result(const BiasResult& a, const BiasResult& b) {
+    EXPECT_EQ(a.score, b.score);
+    EXPECT_EQ(a.label, b.label);
+    EXPECT_EQ(a.confidence, b.confidence);
+    EXPECT_EQ(a.explanations, b.explanations);
+    ASSERT_EQ(a.signals.size(), b.signals.size());
+    for (size_t i = 0; i < a.signals.size(); ++i) {
+        expect_same_output(a.signals[i], b.signals[i]);
+    }
+}
+
+// OutletBaseline is registered first and is the only metadata signal
+constexpr size_t kOutletSignal = 0;
+
+}  // namespace
+
+TEST(ResultCache, CachedResultMatchesUncached) {
+    BiasAggregator uncached;
+    BiasAggregator cached;
+    cached.set_cache_capacity(64);
+
+    const ArticleInput article = make_article("reuters.com");
+    const BiasResult expected = uncached.analyze(article);
+    ASSERT_FALSE(expected.signals.empty());
+
+    const BiasResult first = cached.analyze(article);   // miss, stored
+    const BiasResult second = cached.analyze(article);  // hit
+    expect_same_result(first, expected);
+    expect_same_result(second, expected);
+
+    ResultCache::Stats stats = cached.cache_stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST(ResultCache, DomainChangeRecomputesOnlyTheOutletSignal) {
+    BiasAggregator uncached;
+    BiasAggregator cached;
+    cached.set_cache_capacity(64);
+
+    const ArticleInput left = make_article("msnbc.com");
+    const ArticleInput right = make_article("foxnews.com");
+    const BiasResult from_left = cached.analyze(left);
+    const BiasResult from_right = cached.analyze(right);  // same text: a hit
+    EXPECT_EQ(cached.cache_stats().hits, 1u);
+
+    // The hit is scored exactly like a fresh analysis of its own domain...
+    expect_same_result(from_right, uncached.analyze(right));
+
+    // ...with only the outlet output differing from the cached article's
+    ASSERT_EQ(from_left.signals.size(), from_right.signals.size());
+    EXPECT_NE(from_left.signals[kOutletSignal].score, from_right.signals[kOutletSignal].score);
+    for (size_t i = 0; i < from_left.signals.size(); ++i) {
+        if (i != kOutletSignal) {
+            expect_same_output(from_left.signals[i], from_right.signals[i]);
+        }
+    }
+}
+
+TEST(ResultCache, CaseVariantsShareAnEntry) {
+    ArticleInput article = make_article("reuters.com");
+    ArticleInput shouted = article;
+    for (char& c : shouted.title) {
+        c = static_cast<char>((c >= 'a' && c <= 'z') ? c - 32 : c);
+    }
+    const ResultCache::Key a = ResultCache::key_for(article, 1);
+    const ResultCache::Key b = ResultCache::key_for(shouted, 1);
+    EXPECT_EQ(a.hash, b.hash);
+    EXPECT_EQ(a.check, b.check);
+
+    // Another generation is another key
+    EXPECT_NE(ResultCache::key_for(article, 2).hash, a.hash);
+}
+
+TEST(ResultCache, HashCollisionIsAMiss) {
+    ResultCache cache(8);
+    ResultCache::Entry entry;
+    entry.token_count = 7;
+    cache.insert(ResultCache::Key{42, 1}, entry);
+
+    ResultCache::Entry out;
+    EXPECT_TRUE(cache.lookup(ResultCache::Key{42, 1}, out));
+    EXPECT_EQ(out.token_count, 7u);
+    EXPECT_FALSE(cache.lookup(ResultCache::Key{42, 2}, out));
+}
+
+TEST(ResultCache, EvictsLeastRecentlyUsed) {
+    ResultCache cache(2, 1);
+    ResultCache::Entry entry;
+    cache.insert(ResultCache::Key{1, 1}, entry);
+    cache.insert(ResultCache::Key{2, 2}, entry);
+
+    ResultCache::Entry out;
+    EXPECT_TRUE(cache.lookup(ResultCache::Key{1, 1}, out));  // 2 is now oldest
+    cache.insert(ResultCache::Key{3, 3}, entry);
+
+    EXPECT_FALSE(cache.lookup(ResultCache::Key{2, 2}, out));
+    EXPECT_TRUE(cache.lookup(ResultCache::Key{1, 1}, out));
+    EXPECT_TRUE(cache.lookup(ResultCache::Key{3, 3}, out));
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
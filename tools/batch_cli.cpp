@@ -0,0 +1,430 @@
+// Score newline-delimited JSON articles in bulk: one object per line with
+// "title", "body", "url" and "domain" (and optionally "id", echoed back),
+// read from a file (mmapped) or stdin; one JSON result per line written to
+// stdout or -o, in input order:
+//
+//   {"line":1,"id":17,"score":-0.271562,"label":"Slight Left","confidence":0.689914}
+//   {"line":2,"error":"expected a key"}
+//
+// Three stages overlap: the reader parses the next batch while the
+// aggregator's workers score the current one and the writer formats and
+// flushes the one before. Only kSlots batches exist at a time, so memory is
+// bounded by the batch size whatever the input size, and results leave in
+// input order without a reorder buffer of their own. Consumed input pages
+// are released as the reader moves on. Throughput goes to stderr at the end.
+//
+// Usage: bias_batch [--threads N] [--batch N] [--explain] [-o output.jsonl] [input.jsonl | -]
+
+#include "include/article_line_parser.hpp"
+#include "include/bias_aggregator.hpp"
+#include "include/bias_scoring.hpp"
+#include "include/mapped_file.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Batches in flight: one being parsed, one scored, one written
+constexpr size_t kSlots = 3;
+
+// stdin is read in chunks of this size (grown for longer lines)
+constexpr size_t kReadChunk = 4 << 20;
+
+/**
+ * Lines of the input, as views into the mapping (files) or into a reused
+ * read buffer (stdin; valid until the next call).
+ */
+class LineSource {
+public:
+    bool open(const std::string& path) {
+        if (path == "-") {
+            stream = stdin;
+            return true;
+        }
+        if (!file.open(path)) {
+            return false;
+        }
+        file.advise_sequential();
+        cursor = reinterpret_cast<const char*>(file.data());
+        limit = cursor + file.size();
+        return true;
+    }
+
+    bool next(std::string_view& line) {
+        for (;;) {
+            // cursor is null before the first read and for an empty file,
+            // and memchr must not be given null even for zero bytes
+            const char* newline = (cursor == limit) ? nullptr :
+                static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(limit - cursor)));
+            if (newline != nullptr) {
+                line = std::string_view(cursor, static_cast<size_t>(newline - cursor));
+                consumed += line.size() + 1;
+                cursor = newline + 1;
+                return true;
+            }
+            if (stream == nullptr || !refill()) {
+                if (cursor == limit) {
+                    return false;
+                }
+                line = std::string_view(cursor, static_cast<size_t>(limit - cursor));
+                consumed += line.size();
+                cursor = limit;
+                return true;
+            }
+        }
+    }
+
+    // Input bytes returned so far
+    size_t offset() const { return consumed; }
+
+    // Let go of the input before offset() (mapped files only)
+    void release_consumed() {
+        if (stream == nullptr && consumed > released) {
+            file.release(released, consumed - released);
+            released = consumed;
+        }
+    }
+
+    bool failed() const { return stream != nullptr && std::ferror(stream); }
+
+private:
+    MappedFile file;
+    std::FILE* stream = nullptr;
+    std::vector<char> buffer;
+    const char* cursor = nullptr;
+    const char* limit = nullptr;
+    size_t consumed = 0;
+    size_t released = 0;
+
+    // Keep the partial line, read more after it; false at end of input
+    bool refill() {
+        const size_t kept = static_cast<size_t>(limit - cursor);
+        if (kept > 0) {
+            std::memmove(buffer.data(), cursor, kept);
+        }
+        if (buffer.size() < kept + kReadChunk) {
+            buffer.resize(kept + kReadChunk);
+        }
+        const size_t got = std::fread(buffer.data() + kept, 1, buffer.size() - kept, stream);
+        cursor = buffer.data();
+        limit = buffer.data() + kept + got;
+        return got > 0;
+    }
+};
+
+/**
+ * One batch of records; buffers are reused when the slot comes around again.
+ */
+struct Batch {
+    size_t count = 0;
+    std::vector<ArticleInput> articles;   // parse failures stay empty (and are refused)
+    std::vector<size_t> lines;            // 1-based input line numbers
+    std::vector<std::string> ids;         // raw "id" JSON, may be empty
+    std::vector<std::string> errors;      // parse error, empty if parsed
+    std::vector<BiasResult> results;
+    bool scored = false;                  // results are valid
+};
+
+/**
+ * Slot numbers handed from one stage to the next, in order.
+ */
+class SlotQueue {
+public:
+    void push(size_t slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots.push_back(slot);
+        }
+        ready.notify_one();
+    }
+
+    // false once closed and drained
+    bool pop(size_t& slot) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !slots.empty() || closed; });
+        if (slots.empty()) {
+            return false;
+        }
+        slot = slots.front();
+        slots.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<size_t> slots;
+    bool closed = false;
+};
+
+void append_json_string(std::string& out, std::string_view text) {
+    static const char* hex = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : text) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (byte < 0x20) {
+            out += "\\u00";
+            out.push_back(hex[byte >> 4]);
+            out.push_back(hex[byte & 0xF]);
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+void append_number(std::string& out, double value) {
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.6g", std::isfinite(value) ? value : 0.0);
+    out.append(digits, static_cast<size_t>(length));
+}
+
+void append_record(std::string& out, const Batch& batch, size_t i, bool explain) {
+    out += "{\"line\":";
+    out += std::to_string(batch.lines[i]);
+    if (!batch.ids[i].empty()) {
+        out += ",\"id\":";
+        out += batch.ids[i];
+    }
+    if (!batch.errors[i].empty()) {
+        out += ",\"error\":";
+        append_json_string(out, batch.errors[i]);
+        out += "}\n";
+        return;
+    }
+    const BiasResult& result = batch.results[i];
+    out += ",\"score\":";
+    append_number(out, result.score);
+    out += ",\"label\":";
+    append_json_string(out, result.label);
+    out += ",\"confidence\":";
+    append_number(out, result.confidence);
+    if (explain) {
+        out += ",\"explanations\":[";
+        for (size_t e = 0; e < result.explanations.size(); ++e) {
+            if (e > 0) {
+                out.push_back(',');
+            }
+            append_json_string(out, result.explanations[e]);
+        }
+        out.push_back(']');
+    }
+    out += "}\n";
+}
+
+bool blank(std::string_view line) {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t threads = 0;
+    size_t batch_size = 4096;
+    bool explain = false;
+    const char* output_path = nullptr;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_size = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--explain") == 0) {
+            explain = true;
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() > 1) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--threads N] [--batch N] [--explain] [-o output.jsonl] [input.jsonl | -]"
+                  << std::endl;
+        return 2;
+    }
+
+    LineSource source;
+    const std::string input = paths.empty() ? "-" : paths[0];
+    if (!source.open(input)) {
+        std::cerr << "error: cannot open " << input << std::endl;
+        return 1;
+    }
+    std::FILE* out = output_path ? std::fopen(output_path, "wb") : stdout;
+    if (out == nullptr) {
+        std::cerr << "error: cannot write " << output_path << std::endl;
+        return 1;
+    }
+    std::vector<char> out_buffer(1 << 20);
+    std::setvbuf(out, out_buffer.data(), _IOFBF, out_buffer.size());
+
+    BiasAggregator aggregator;
+    aggregator.set_thread_count(threads);
+    AnalysisOptions options;
+    options.render_explanations = explain;
+
+    std::vector<Batch> batches(kSlots);
+    SlotQueue free_slots;
+    SlotQueue to_score;
+    SlotQueue to_write;
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+        free_slots.push(slot);
+    }
+
+    size_t records = 0;
+    size_t errors = 0;
+    size_t refused = 0;
+    std::exception_ptr failure;          // read after the scorer has joined
+    std::atomic<bool> stopped{false};
+
+    // Scorer: one analyze_batch() per batch across the aggregator's workers
+    std::thread scorer([&] {
+        size_t slot = 0;
+        while (to_score.pop(slot)) {
+            Batch& batch = batches[slot];
+            batch.scored = false;
+            if (!stopped) {
+                try {
+                    batch.results = aggregator.analyze_batch(batch.articles, options);
+                    batch.scored = true;
+                } catch (...) {
+                    failure = std::current_exception();
+                    stopped = true;
+                }
+            }
+            to_write.push(slot);
+        }
+        to_write.close();
+    });
+
+    // Writer: formats and writes each batch in order, then recycles its slot
+    std::thread writer([&] {
+        std::string text;
+        size_t slot = 0;
+        while (to_write.pop(slot)) {
+            Batch& batch = batches[slot];
+            if (batch.scored) {
+                text.clear();
+                for (size_t i = 0; i < batch.count; ++i) {
+                    append_record(text, batch, i, explain);
+                    errors += !batch.errors[i].empty();
+                    refused += batch.errors[i].empty() &&
+                               batch.results[i].label == kInsufficientDataLabel;
+                }
+                records += batch.count;
+                std::fwrite(text.data(), 1, text.size(), out);
+            }
+            free_slots.push(slot);
+        }
+    });
+
+    // Reader (this thread): parse lines into the next free batch
+    auto start = std::chrono::steady_clock::now();
+    ArticleLineParser parser;
+    size_t line_number = 0;
+    bool more = true;
+    while (more && !stopped) {
+        size_t slot = 0;
+        if (!free_slots.pop(slot)) {
+            break;
+        }
+        Batch& batch = batches[slot];
+        batch.count = 0;
+        std::string_view line;
+        while (batch.count < batch_size) {
+            if (!source.next(line)) {
+                more = false;
+                break;
+            }
+            ++line_number;
+            if (blank(line)) {
+                continue;
+            }
+            const size_t i = batch.count++;
+            if (batch.articles.size() < batch.count) {
+                batch.articles.emplace_back();
+                batch.lines.emplace_back();
+                batch.ids.emplace_back();
+                batch.errors.emplace_back();
+            }
+            batch.lines[i] = line_number;
+            if (parser.parse(line, batch.articles[i])) {
+                batch.ids[i].assign(parser.id());
+                batch.errors[i].clear();
+            } else {
+                // Nothing left for the aggregator but an instant refusal
+                ArticleInput& article = batch.articles[i];
+                article.title.clear();
+                article.body.clear();
+                article.url.clear();
+                article.domain.clear();
+                batch.ids[i].clear();
+                batch.errors[i] = parser.error();
+            }
+        }
+        source.release_consumed();
+
+        if (batch.count == 0) {
+            free_slots.push(slot);
+            continue;
+        }
+        // analyze_batch() takes the whole vector (only the last batch is short)
+        batch.articles.resize(batch.count);
+        to_score.push(slot);
+    }
+    to_score.close();
+    scorer.join();
+    writer.join();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (failure) {
+        try {
+            std::rethrow_exception(failure);
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << e.what() << std::endl;
+        }
+        return 1;
+    }
+    if (source.failed()) {
+        std::cerr << "error: cannot read " << input << std::endl;
+        return 1;
+    }
+    if (std::fflush(out) != 0 || std::ferror(out) || (output_path && std::fclose(out) != 0)) {
+        std::cerr << "error: cannot write " << (output_path ? output_path : "stdout") << std::endl;
+        return 1;
+    }
+
+    const double megabytes = source.offset() / 1e6;
+    std::fprintf(stderr,
+                 "bias_batch: %zu articles (%zu unparsable, %zu refused), %.1f MB in %.2f s: "
+                 "%.0f articles/s, %.1f MB/s\n",
+                 records, errors, refused, megabytes, seconds,
+                 seconds > 0 ? records / seconds : 0.0, seconds > 0 ? megabytes / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Convert pretrained word vectors (GloVe / fastText .vec text, word2vec
+// .bin) into the binary image that WordEmbeddings mmaps at startup, with
+// the reference directions built from a seed list.
+//
+// Usage: bias_embedding_compiler [--f16] [--max-words N] <vectors> <seeds.tsv> <output.bin>
+
+#include "include/embedding_builder.hpp"
+#include "include/mapped_file.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    EmbeddingPrecision precision = EmbeddingPrecision::Float32;
+    size_t max_words = 0;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--f16") == 0) {
+            precision = EmbeddingPrecision::Float16;
+        } else if (std::strcmp(argv[i], "--max-words") == 0 && i + 1 < argc) {
+            max_words = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 3) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--f16] [--max-words N] <vectors> <seeds.tsv> <output.bin>" << std::endl;
+        return 2;
+    }
+
+    EmbeddingBuilder builder;
+    if (!builder.load_vectors(paths[0], max_words) || !builder.load_seeds(paths[1])) {
+        std::cerr << "error: " << builder.error() << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> image = builder.compile(precision);
+
+    // Round-trip through the loader so a bad image never gets deployed
+    WordEmbeddings check;
+    if (!check.load_image(image)) {
+        std::cerr << "error: compiled image failed validation" << std::endl;
+        return 1;
+    }
+    if (check.reference("left") == nullptr || check.reference("right") == nullptr) {
+        std::cerr << "warning: no seed of \"left\" or \"right\" has a vector; "
+                  << "SemanticBias will keep using the lexicon" << std::endl;
+    }
+
+    // Replaced atomically: running services may have the old image mapped
+    if (!write_file_atomically(paths[2], image)) {
+        std::cerr << "error: cannot write " << paths[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "embeddings: " << builder.word_count() << " words x " << builder.dimension()
+              << (precision == EmbeddingPrecision::Float16 ? " (f16), " : " (f32), ")
+              << check.reference_count() << " references -> "
+              << paths[2] << " (" << image.size() << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,233 @@
+// Embed a corpus of articles with hand-assigned bias ratings and link it
+// into the HNSW graph that KnnIndex mmaps at startup (deploy the output as
+// config/knn_index.bin to enable KnnBias).
+//
+// Input is JSON lines, one article per line:
+//   {"title": "...", "body": "...", "rating": -0.4}
+// ("score" is accepted for "rating"; ratings are clamped to [-1, 1]; other
+// fields are ignored). Articles are embedded with the deployed word vectors
+// (config/embeddings.bin), the same way KnnBiasSignal embeds a query. The
+// index must be rebuilt whenever those vectors change.
+//
+// Usage: bias_knn_compiler [--m N] [--ef-construction N] [--ef-search N]
+//                          [--threads N] <labeled.jsonl> <output.bin>
+
+#include "include/json_reader.hpp"
+#include "include/knn_index_builder.hpp"
+#include "include/mapped_file.hpp"
+#include "include/nlp_context.hpp"
+#include "include/preprocessor.hpp"
+#include "include/thread_pool.hpp"
+#include "include/word_embeddings.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Articles embedded per round; bounds the memory of one round
+constexpr size_t kWindow = 4096;
+
+struct LabeledArticle {
+    ArticleInput article;
+    float rating = 0.0f;
+};
+
+// One JSON line: picks title, body and rating from the top-level object
+class LabeledArticleHandler : public JsonHandler {
+public:
+    explicit LabeledArticleHandler(LabeledArticle& out) : out(out) {}
+
+    bool has_rating() const { return rated; }
+
+    bool start_object() override {
+        ++depth;
+        return true;
+    }
+    bool end_object() override {
+        --depth;
+        return true;
+    }
+    bool start_array() override {
+        if (depth == 0) {
+            return stop("expected an object");
+        }
+        ++depth;
+        return true;
+    }
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+    bool key(std::string_view name) override {
+        if (depth == 1) {
+            field = (name == "title") ? Field::Title
+                  : (name == "body") ? Field::Body
+                  : (name == "rating" || name == "score") ? Field::Rating
+                  : Field::Other;
+        }
+        return true;
+    }
+    bool string(std::string_view value) override {
+        if (depth != 1) {
+            return depth > 1 || stop("expected an object");
+        }
+        if (field == Field::Title) {
+            out.article.title = value;
+        } else if (field == Field::Body) {
+            out.article.body = value;
+        } else if (field == Field::Rating) {
+            return stop("rating must be a number");
+        }
+        return true;
+    }
+    bool number(double value) override {
+        if (depth == 1 && field == Field::Rating) {
+            out.rating = static_cast<float>(value);
+            rated = true;
+        }
+        return depth > 0 || stop("expected an object");
+    }
+
+private:
+    enum class Field { Other, Title, Body, Rating };
+
+    LabeledArticle& out;
+    Field field = Field::Other;
+    size_t depth = 0;
+    bool rated = false;
+};
+
+bool blank(const std::string& line) {
+    return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    KnnIndexBuilder::Options options;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--m") == 0 && i + 1 < argc) {
+            options.m = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--ef-construction") == 0 && i + 1 < argc) {
+            options.ef_construction = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--ef-search") == 0 && i + 1 < argc) {
+            options.ef_search = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--m N] [--ef-construction N] [--ef-search N] [--threads N]"
+                  << " <labeled.jsonl> <output.bin>" << std::endl;
+        return 2;
+    }
+
+    // Embedding source: the one KnnBiasSignal will query with
+    std::shared_ptr<const WordEmbeddings> embeddings = WordEmbeddings::current();
+    if (embeddings->empty()) {
+        std::cerr << "error: no word vectors deployed in " << WordEmbeddings::kDefaultImagePath
+                  << " (see bias_embedding_compiler)" << std::endl;
+        return 1;
+    }
+    const size_t dimension = embeddings->dimension();
+
+    std::ifstream in(paths[0]);
+    if (!in.is_open()) {
+        std::cerr << "error: cannot open " << paths[0] << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    Preprocessor preprocessor;
+    std::vector<NLPContext> contexts(pool.size());
+    KnnIndexBuilder builder(dimension, KnnSpace::WordVectors, embeddings->fingerprint());
+    JsonReader reader;
+    size_t line_number = 0;
+    size_t skipped = 0;
+    std::vector<LabeledArticle> window;
+    std::vector<float> rows;
+
+    // Embed a window of articles in parallel and add the non-empty ones
+    auto flush = [&]() {
+        rows.assign(window.size() * dimension, 0.0f);
+        pool.parallel_for(window.size(), [&](size_t worker, size_t i) {
+            preprocessor.process(window[i].article, contexts[worker]);
+            embeddings->embed(contexts[worker], rows.data() + i * dimension);
+        });
+        for (size_t i = 0; i < window.size(); ++i) {
+            if (!builder.add(rows.data() + i * dimension, window[i].rating)) {
+                ++skipped;  // no text, or no known word
+            }
+        }
+        window.clear();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::string line;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (blank(line)) {
+            continue;
+        }
+        LabeledArticle labeled;
+        LabeledArticleHandler handler(labeled);
+        if (!reader.parse(line, handler)) {
+            std::cerr << "error: " << paths[0] << ":" << line_number << ": " << reader.error()
+                      << std::endl;
+            return 1;
+        }
+        if (!handler.has_rating()) {
+            std::cerr << "error: " << paths[0] << ":" << line_number << ": no rating" << std::endl;
+            return 1;
+        }
+        window.push_back(std::move(labeled));
+        if (window.size() == kWindow) {
+            flush();
+        }
+    }
+    if (!window.empty()) {
+        flush();
+    }
+    if (builder.size() == 0) {
+        std::cerr << "error: no article could be embedded" << std::endl;
+        return 1;
+    }
+    const double embed_seconds = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> image = builder.compile(options);
+    const double build_seconds = seconds_since(start);
+
+    // Round-trip through the loader so a bad image never gets deployed
+    KnnIndex check;
+    if (!check.load_image(image)) {
+        std::cerr << "error: compiled image failed validation" << std::endl;
+        return 1;
+    }
+
+    // Replaced atomically: running services may have the old image mapped
+    if (!write_file_atomically(paths[1], image)) {
+        std::cerr << "error: cannot write " << paths[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "knn index: " << builder.size() << " articles x " << dimension
+              << ", m " << options.m << ", " << skipped << " skipped; embedded in "
+              << embed_seconds << " s, linked in " << build_seconds << " s -> " << paths[1]
+              << " (" << image.size() << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+// Compile lexicon source tables (config/lexicon/*.tsv) into the binary image
+// that Lexicon mmaps at startup.
+//
+// Usage: bias_lexicon_compiler <source_dir> <output.bin>
+
+#include "include/lexicon_builder.hpp"
+#include "include/mapped_file.hpp"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <source_dir> <output.bin>" << std::endl;
+        return 2;
+    }
+
+    LexiconBuilder builder;
+    if (!builder.load_directory(argv[1])) {
+        std::cerr << "error: " << builder.error() << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> image = builder.compile();
+
+    // Round-trip through the loader so a bad image never gets deployed
+    Lexicon check;
+    if (!check.load_image(image)) {
+        std::cerr << "error: compiled image failed validation" << std::endl;
+        return 1;
+    }
+
+    // Replaced atomically: running services may have the old image mapped
+    if (!write_file_atomically(argv[2], image)) {
+        std::cerr << "error: cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "lexicon: " << builder.word_count() << " words, "
+              << builder.phrase_count() << " phrases, "
+              << builder.entity_count() << " entities -> "
+              << argv[2] << " (" << image.size() << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,40 @@
+// Compile outlet ratings (config/outlets.json) into the binary image that
+// OutletTable mmaps at startup.
+//
+// Usage: bias_outlet_compiler <outlets.json> <output.bin>
+
+#include "include/mapped_file.hpp"
+#include "include/outlet_table_builder.hpp"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <outlets.json> <output.bin>" << std::endl;
+        return 2;
+    }
+
+    OutletTableBuilder builder;
+    if (!builder.load_json(argv[1])) {
+        std::cerr << "error: " << builder.error() << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> image = builder.compile();
+
+    // Round-trip through the loader so a bad image never gets deployed
+    OutletTable check;
+    if (!check.load_image(image)) {
+        std::cerr << "error: compiled image failed validation" << std::endl;
+        return 1;
+    }
+
+    // Replaced atomically: running services may have the old image mapped
+    if (!write_file_atomically(argv[2], image)) {
+        std::cerr << "error: cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "outlets: " << builder.outlet_count() << " domains -> "
+              << argv[2] << " (" << image.size() << " bytes)" << std::endl;
+    return 0;
+}